@@ -0,0 +1,48 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#
+# Times the vertex conversion of the 2D renderer with a debug build of the extension:
+#   godot --headless --path demo -s res://addons/gd_cubism/example/bench_vertex_kernel.gd
+#
+# legacy: make_Vertices into a PackedVector2Array, then the bounds over it (the path before write_Vertices)
+# scalar: write_Vertices_scalar
+# simd:   write_Vertices, AVX / SSE2 / NEON as the build targets
+extends SceneTree
+
+
+# drawables of typical Live2D models range from a few dozen to a few thousand vertices
+const VERTEX_COUNTS: Array[int] = [64, 256, 1024, 4096]
+# vertices converted per measurement, whatever the drawable size
+const VERTEX_TOTAL: int = 16 * 1024 * 1024
+
+
+func _init():
+    if ClassDB.class_exists("GDCubismBenchmark") == false:
+        printerr("GDCubismBenchmark is only registered in debug builds of gd_cubism.")
+        quit(1)
+        return
+
+    # looked up by name, the class does not exist in release builds
+    var bench: Object = ClassDB.instantiate("GDCubismBenchmark")
+
+    print("vertices  iterations  legacy(ms)  scalar(ms)  simd(ms)  legacy/simd  scalar/simd  match")
+    for vertex_count in VERTEX_COUNTS:
+        var iterations: int = VERTEX_TOTAL / vertex_count
+        # the first run warms the caches up and is not printed
+        bench.call("vertex_kernel", vertex_count, iterations / 16)
+        var result: Dictionary = bench.call("vertex_kernel", vertex_count, iterations)
+
+        var simd: float = maxf(result.simd_usec, 1.0)
+        print("%8d  %10d  %10.2f  %10.2f  %8.2f  %10.2fx  %10.2fx  %s" % [
+            vertex_count,
+            iterations,
+            result.legacy_usec / 1000.0,
+            result.scalar_usec / 1000.0,
+            result.simd_usec / 1000.0,
+            result.legacy_usec / simd,
+            result.scalar_usec / simd,
+            result.match
+        ])
+
+    bench.free()
+    quit()
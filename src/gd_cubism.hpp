@@ -7,7 +7,7 @@
 // ----------------------------------------------------------------- include(s)
 // ------------------------------------------------------------------ define(s)
 #define GD_CUBISM_USE_RENDERER_2D
-//#define GD_CUBISM_USE_RENDERER_3D
+// 3D scenes are drawn by GDCubismModel3D from the output of the 2D renderer
 
 #ifdef GD_CUBISM_USE_RENDERER_2D
 const bool SUBVIEWPORT_DISABLE_3D_FLAG = true;
@@ -34,6 +34,7 @@ enum GDCubismShader {
     GD_CUBISM_SHADER_MASK_MIX_INV,
     GD_CUBISM_SHADER_MASK_MUL,
     GD_CUBISM_SHADER_MASK_MUL_INV,
+    GD_CUBISM_SHADER_CLIP,
     GD_CUBISM_SHADER_MAX
 };
 
@@ -41,6 +42,11 @@ enum GDCubismShader {
 // ------------------------------------------------------------------- const(s)
 const static int MAX_PRINTLOG_LENGTH = 256;
 
+// mask atlas layout, the alpha channel is left out as it can not be blended additively
+const static int MASK_ATLAS_SIZE_DEFAULT = 1024;
+const static int MASK_ATLAS_CHANNELS = 3;
+const static int MASK_ATLAS_GRID = 3;
+
 const static bool DEFAULT_PROP_ANIM_LOOP = false;
 const static bool DEFAULT_PROP_ANIM_LOOP_FADE_IN = true;
 
@@ -54,6 +60,28 @@ const static char* PROP_PART_OPACITY_GROUP = "PartOpacity";
 
 const static char* SIGNAL_EFFECT_HIT_AREA_ENTERED = "hit_area_entered";
 const static char* SIGNAL_EFFECT_HIT_AREA_EXITED = "hit_area_exited";
+const static char* SIGNAL_LOD_CHANGED = "lod_changed";
+const static char* SIGNAL_MODEL_LOADED = "model_loaded";
+
+// share of the load progress given to reading the files, the rest goes to building the drawables
+const static float LOAD_PROGRESS_READ = 0.5f;
+
+// a level of detail is left for a finer one only once the model is this much larger than its screen_size
+const static float LOD_HYSTERESIS = 1.125f;
+// seconds between bounds refreshes of a culled model that is still simulated, so it is found on screen again
+const static float CULL_BOUNDS_INTERVAL = 0.25f;
+// delta times summed frame by frame round below the interval they should reach
+const static float UPDATE_INTERVAL_EPSILON = 1.0e-4f;
+
+// longest side of an impostor texture, and how far the model may be scaled before it is captured again
+const static int IMPOSTOR_SIZE_MAX = 2048;
+const static float IMPOSTOR_RESCALE_RATIO = 1.25f;
+
+// sorting offset between two runs of a 3D model, small enough to keep the model in place among other objects
+const static float MESH_3D_SORTING_STEP = 1.0e-4f;
+
+// objects of each kind kept for reuse once their model released them, anything past this is freed
+const static int OBJECT_POOL_SIZE_MAX = 2048;
 
 const static char* MOTION_FILE_EXTENSION = "motion3.json";
 const static char* EXPRESSION_FILE_EXTENSION = "exp3.json";
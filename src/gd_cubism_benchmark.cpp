@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+#include <Type/csmVector.hpp>
+
+#include <private/internal_cubism_vertex_kernel.hpp>
+#include <gd_cubism_benchmark.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// the ppunit of a 2048 px canvas, what CALCULATED_PPUNIT_C usually comes to
+const static float BENCHMARK_PPUNIT = 1024.0f;
+
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// the conversion used before write_Vertices, see internal_cubism_renderer_2d.cpp
+PackedVector2Array make_Vertices(const Live2D::Cubism::Core::csmVector2 *ptr, const int32_t &size, const Csm::csmFloat32 &ppunit);
+
+// ------------------------------------------------------------------- class(s)
+void GDCubismBenchmark::_bind_methods() {
+    ClassDB::bind_static_method("GDCubismBenchmark", D_METHOD("vertex_kernel", "vertex_count", "iterations"), &GDCubismBenchmark::vertex_kernel);
+}
+
+
+Dictionary GDCubismBenchmark::vertex_kernel(const int32_t vertex_count, const int32_t iterations) {
+    Dictionary dict_result;
+    ERR_FAIL_COND_V(vertex_count <= 0 || iterations <= 0, dict_result);
+
+    // the same positions on every run, a drawable spread over the unit canvas
+    Csm::csmVector<Live2D::Cubism::Core::csmVector2> ary_src;
+    ary_src.Resize(vertex_count);
+    uint32_t seed = 0x2545F491;
+    for (int32_t i = 0; i < vertex_count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        ary_src[i].X = float(seed >> 8) / float(1 << 24) * 2.0f - 1.0f;
+        seed = seed * 1664525u + 1013904223u;
+        ary_src[i].Y = float(seed >> 8) / float(1 << 24) * 2.0f - 1.0f;
+    }
+    const Live2D::Cubism::Core::csmVector2 *src = ary_src.GetPtr();
+    const int32_t stride = sizeof(float) * 2;
+
+    PackedByteArray ary_simd;
+    PackedByteArray ary_scalar;
+    ary_simd.resize(vertex_count * stride);
+    ary_scalar.resize(vertex_count * stride);
+
+    Time *time = Time::get_singleton();
+    // summed so the compiler keeps every pass
+    float sink = 0.0f;
+    Rect2 bounds_simd;
+    Rect2 bounds_scalar;
+    Rect2 bounds_legacy;
+
+    // make_Vertices followed by the bounds, what ArrayMesh computed when the surface was added
+    uint64_t usec = time->get_ticks_usec();
+    for (int32_t n = 0; n < iterations; n++) {
+        const PackedVector2Array ary = make_Vertices(src, vertex_count, BENCHMARK_PPUNIT);
+        const Vector2 *vtx = ary.ptr();
+        bounds_legacy = Rect2(vtx[0], Vector2());
+        for (int32_t i = 1; i < vertex_count; i++) bounds_legacy.expand_to(vtx[i]);
+        sink += bounds_legacy.size.x;
+    }
+    const uint64_t usec_legacy = time->get_ticks_usec() - usec;
+
+    usec = time->get_ticks_usec();
+    for (int32_t n = 0; n < iterations; n++) {
+        bounds_scalar = write_Vertices_scalar(src, vertex_count, BENCHMARK_PPUNIT, stride, ary_scalar.ptrw());
+        sink += bounds_scalar.size.x;
+    }
+    const uint64_t usec_scalar = time->get_ticks_usec() - usec;
+
+    usec = time->get_ticks_usec();
+    for (int32_t n = 0; n < iterations; n++) {
+        bounds_simd = write_Vertices(src, vertex_count, BENCHMARK_PPUNIT, stride, ary_simd.ptrw());
+        sink += bounds_simd.size.x;
+    }
+    const uint64_t usec_simd = time->get_ticks_usec() - usec;
+
+    dict_result["vertex_count"] = vertex_count;
+    dict_result["iterations"] = iterations;
+    dict_result["legacy_usec"] = int64_t(usec_legacy);
+    dict_result["scalar_usec"] = int64_t(usec_scalar);
+    dict_result["simd_usec"] = int64_t(usec_simd);
+    // the vector path has to give the same vertices and bounds as the reference
+    dict_result["match"] = ary_simd == ary_scalar && bounds_simd == bounds_scalar && bounds_legacy.is_equal_approx(bounds_scalar);
+    dict_result["checksum"] = sink;
+
+    return dict_result;
+}
+
+
+// ------------------------------------------------------------------ method(s)
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef GD_CUBISM_BENCHMARK_H
+#define GD_CUBISM_BENCHMARK_H
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+
+// Timings of the internal kernels on synthetic input, registered in debug builds only.
+// See addons/gd_cubism/example/bench_vertex_kernel.gd in the demo project.
+class GDCubismBenchmark : public Object {
+    GDCLASS(GDCubismBenchmark, Object)
+
+protected:
+    static void _bind_methods();
+
+public:
+    static Dictionary vertex_kernel(const int32_t vertex_count, const int32_t iterations);
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // GD_CUBISM_BENCHMARK_H
@@ -60,6 +60,14 @@ private:
     bool _monitoring = true;
     Dictionary _dict_monitoring;
 
+    // get_meshes() holds MeshInstance2D nodes, or the ArrayMesh itself with the RenderingServer backend
+    Ref<ArrayMesh> get_array_mesh(const Variant& value) const {
+        MeshInstance2D* p_mesh_inst = cast_to<MeshInstance2D>(value);
+        if(p_mesh_inst != nullptr) return Ref<ArrayMesh>(cast_to<ArrayMesh>(p_mesh_inst->get_mesh().ptr()));
+
+        return Ref<ArrayMesh>(cast_to<ArrayMesh>(value));
+    }
+
     Rect2 build_rect2(const Ref<ArrayMesh>& ref_ary_mesh) const {
         Array ary = ref_ary_mesh->surface_get_arrays(0);
         PackedVector2Array ary_vtx = ary[Mesh::ARRAY_VERTEX];
@@ -121,8 +129,7 @@ public:
         const Dictionary dict_mesh = model->get_meshes();
         if(dict_mesh.is_empty() == true) return Dictionary();
 
-        MeshInstance2D* p_mesh_inst = cast_to<MeshInstance2D>(dict_mesh[id]);
-        Ref<ArrayMesh> ref_ary_mesh =  static_cast<ArrayMesh*>(p_mesh_inst->get_mesh().ptr());
+        Ref<ArrayMesh> ref_ary_mesh = this->get_array_mesh(dict_mesh.get(id, Variant()));
         if(ref_ary_mesh.is_valid() != true) return Dictionary();
         if(ref_ary_mesh->surface_get_array_index_len(0) < 3) return Dictionary();
 
@@ -177,8 +184,7 @@ public:
             const String id = static_cast<Dictionary>(ary[i]).get("id", String());
             if(dict_mesh.has(id) != true) continue;
 
-            MeshInstance2D* p_mesh_inst = cast_to<MeshInstance2D>(dict_mesh[id]);
-            Ref<ArrayMesh> ref_ary_mesh =  static_cast<ArrayMesh*>(p_mesh_inst->get_mesh().ptr());
+            Ref<ArrayMesh> ref_ary_mesh = this->get_array_mesh(dict_mesh[id]);
             if(ref_ary_mesh.is_valid() != true) continue;
             if(ref_ary_mesh->surface_get_array_index_len(0) < 3) continue;
 
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef GD_CUBISM_LEVEL_OF_DETAIL_H
+#define GD_CUBISM_LEVEL_OF_DETAIL_H
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/core/property_info.hpp>
+#include <godot_cpp/classes/resource.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+class GDCubismUserModel;
+
+
+// ------------------------------------------------------------------- class(s)
+class GDCubismLevelOfDetail : public godot::Resource {
+    GDCLASS(GDCubismLevelOfDetail, godot::Resource)
+    friend GDCubismUserModel;
+
+protected:
+    static void _bind_methods() {
+        ClassDB::bind_method(D_METHOD("set_screen_size", "value"), &GDCubismLevelOfDetail::set_screen_size);
+        ClassDB::bind_method(D_METHOD("get_screen_size"), &GDCubismLevelOfDetail::get_screen_size);
+        ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "screen_size", PROPERTY_HINT_RANGE, "0.0,4096.0,1.0,or_greater"), "set_screen_size", "get_screen_size");
+
+        ClassDB::bind_method(D_METHOD("set_drawable_area_min", "value"), &GDCubismLevelOfDetail::set_drawable_area_min);
+        ClassDB::bind_method(D_METHOD("get_drawable_area_min"), &GDCubismLevelOfDetail::get_drawable_area_min);
+        ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "drawable_area_min", PROPERTY_HINT_RANGE, "0.0,1024.0,0.5,or_greater"), "set_drawable_area_min", "get_drawable_area_min");
+
+        ClassDB::bind_method(D_METHOD("set_mask_scale", "value"), &GDCubismLevelOfDetail::set_mask_scale);
+        ClassDB::bind_method(D_METHOD("get_mask_scale"), &GDCubismLevelOfDetail::get_mask_scale);
+        ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "mask_scale", PROPERTY_HINT_RANGE, "0.05,1.0,0.05"), "set_mask_scale", "get_mask_scale");
+
+        ClassDB::bind_method(D_METHOD("set_update_interval", "value"), &GDCubismLevelOfDetail::set_update_interval);
+        ClassDB::bind_method(D_METHOD("get_update_interval"), &GDCubismLevelOfDetail::get_update_interval);
+        ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,1.0,0.01,or_greater"), "set_update_interval", "get_update_interval");
+    }
+
+private:
+    // longest side of the model on screen in pixels, up to which this level is used
+    float screen_size = 256.0;
+    // on screen area in pixels below which a drawable is not drawn
+    float drawable_area_min = 0.0;
+    float mask_scale = 1.0;
+    // seconds between updates, 0 updates every frame
+    float update_interval = 0.0;
+
+public:
+    void set_screen_size(const float value) { this->screen_size = value; }
+    float get_screen_size() const { return this->screen_size; }
+
+    void set_drawable_area_min(const float value) { this->drawable_area_min = value; }
+    float get_drawable_area_min() const { return this->drawable_area_min; }
+
+    void set_mask_scale(const float value) { this->mask_scale = value; }
+    float get_mask_scale() const { return this->mask_scale; }
+
+    void set_update_interval(const float value) { this->update_interval = value; }
+    float get_update_interval() const { return this->update_interval; }
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // GD_CUBISM_LEVEL_OF_DETAIL_H
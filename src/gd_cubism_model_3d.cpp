@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/core/class_db.hpp>
+
+#include <private/internal_cubism_renderer_3d.hpp>
+#include <private/internal_cubism_user_model.hpp>
+#include <gd_cubism_model_3d.hpp>
+#include <gd_cubism_user_model.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+GDCubismModel3D::GDCubismModel3D()
+    : pixel_size(0.001)
+    , model_node(nullptr)
+    , renderer(memnew(InternalCubismRenderer3D(this))) {
+}
+
+
+GDCubismModel3D::~GDCubismModel3D() {
+    memdelete(this->renderer);
+}
+
+
+void GDCubismModel3D::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_model", "value"), &GDCubismModel3D::set_model);
+    ClassDB::bind_method(D_METHOD("get_model"), &GDCubismModel3D::get_model);
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "model", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "GDCubismUserModel"), "set_model", "get_model");
+
+    ClassDB::bind_method(D_METHOD("set_pixel_size", "value"), &GDCubismModel3D::set_pixel_size);
+    ClassDB::bind_method(D_METHOD("get_pixel_size"), &GDCubismModel3D::get_pixel_size);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pixel_size", PROPERTY_HINT_RANGE, "0.0001,0.1,0.0001,or_greater"), "set_pixel_size", "get_pixel_size");
+}
+
+
+void GDCubismModel3D::_notification(int p_what) {
+    // the model may enter the tree after this node, it is looked up again once everything is ready
+    if (p_what == NOTIFICATION_ENTER_TREE || p_what == NOTIFICATION_READY) {
+        this->attach();
+    }
+    if (p_what == NOTIFICATION_EXIT_TREE) {
+        if(this->model_node != nullptr) this->model_node->_on_detach_model_3d(this);
+        this->detach();
+    }
+}
+
+
+void GDCubismModel3D::attach() {
+    if(this->model_node != nullptr || this->is_inside_tree() == false) return;
+    if(this->model.is_empty() == true) return;
+
+    GDCubismUserModel *node = Object::cast_to<GDCubismUserModel>(this->get_node_or_null(this->model));
+    if(node == nullptr) return;
+
+    this->model_node = node;
+    node->_on_attach_model_3d(this);
+}
+
+
+void GDCubismModel3D::release_items() {
+    this->renderer->clear();
+}
+
+
+void GDCubismModel3D::refresh(InternalCubismUserModel *model, const bool structure_changed) {
+    model->mirror_update(*this->renderer, structure_changed);
+}
+
+
+void GDCubismModel3D::detach() {
+    this->release_items();
+    this->model_node = nullptr;
+}
+
+
+void GDCubismModel3D::set_model(const NodePath &value) {
+    if(this->model == value) return;
+    this->model = value;
+
+    if(this->model_node != nullptr) this->model_node->_on_detach_model_3d(this);
+    this->detach();
+    this->attach();
+}
+
+
+void GDCubismModel3D::set_pixel_size(const float value) {
+    this->pixel_size = MAX(value, 0.0f);
+    this->renderer->set_pixel_size(this->pixel_size);
+    // a model holding still sends no update, the bounds are placed again right away
+    if(this->model_node != nullptr && this->model_node->is_initialized() == true) {
+        this->refresh(this->model_node->internal_model, false);
+    }
+}
+
+
+// ------------------------------------------------------------------ method(s)
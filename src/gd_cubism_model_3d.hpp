@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef GD_CUBISM_MODEL_3D_H
+#define GD_CUBISM_MODEL_3D_H
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+class GDCubismUserModel;
+class InternalCubismUserModel;
+class InternalCubismRenderer3D;
+
+
+// ------------------------------------------------------------------- class(s)
+class GDCubismModel3D : public MeshInstance3D {
+    GDCLASS(GDCubismModel3D, MeshInstance3D)
+    friend GDCubismUserModel;
+
+public:
+    GDCubismModel3D();
+    ~GDCubismModel3D();
+
+protected:
+    static void _bind_methods();
+    void _notification(int p_what);
+
+private:
+    NodePath model;
+    float pixel_size;
+    // the model the mesh is attached to while both are in the tree
+    GDCubismUserModel *model_node;
+    InternalCubismRenderer3D *renderer;
+
+private:
+    void attach();
+    void release_items();
+    // called by the model
+    void refresh(InternalCubismUserModel *model, const bool structure_changed);
+    void detach();
+
+public:
+    void set_model(const NodePath &value);
+    NodePath get_model() const { return this->model; }
+
+    void set_pixel_size(const float value);
+    float get_pixel_size() const { return this->pixel_size; }
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // GD_CUBISM_MODEL_3D_H
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/core/class_db.hpp>
+
+#include <private/internal_cubism_model_data.hpp>
+#include <gd_cubism_model_data.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+GDCubismModelData::GDCubismModelData()
+    : data(memnew(InternalCubismModelData)) {
+}
+
+
+GDCubismModelData::~GDCubismModelData() {
+    memdelete(this->data);
+}
+
+
+void GDCubismModelData::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_loaded"), &GDCubismModelData::is_loaded);
+    ClassDB::bind_method(D_METHOD("get_textures"), &GDCubismModelData::get_textures);
+}
+
+
+Error GDCubismModelData::load(const String &pathname) {
+    // loaded once, a resource from the cache is never filled again
+    ERR_FAIL_COND_V(this->data->is_loaded() == true, ERR_ALREADY_IN_USE);
+    if(this->data->load(pathname) == false) return ERR_FILE_CORRUPT;
+    return OK;
+}
+
+
+bool GDCubismModelData::is_loaded() const {
+    return this->data->is_loaded();
+}
+
+
+Array GDCubismModelData::get_textures() const {
+    return this->data->ary_texture.duplicate();
+}
+
+
+// ------------------------------------------------------------------ method(s)
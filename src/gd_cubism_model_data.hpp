@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef GD_CUBISM_MODEL_DATA_H
+#define GD_CUBISM_MODEL_DATA_H
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/array.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+class GDCubismUserModel;
+class InternalCubismModelData;
+
+
+// ------------------------------------------------------------------- class(s)
+class GDCubismModelData : public godot::Resource {
+    GDCLASS(GDCubismModelData, godot::Resource)
+    friend GDCubismUserModel;
+
+protected:
+    static void _bind_methods();
+
+private:
+    // files, textures, setting and moc, each model creates its own instance from the moc
+    InternalCubismModelData *data;
+
+public:
+    GDCubismModelData();
+    ~GDCubismModelData();
+
+    Error load(const String &pathname);
+    bool is_loaded() const;
+
+    Array get_textures() const;
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // GD_CUBISM_MODEL_DATA_H
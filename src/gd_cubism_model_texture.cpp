@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+
+#include <private/internal_cubism_user_model.hpp>
+#include <gd_cubism_model_texture.hpp>
+#include <gd_cubism_user_model.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+GDCubismModelTexture::GDCubismModelTexture()
+    : render_size(512, 512)
+    , items_dirty(true) {
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    this->viewport = rs->viewport_create();
+    rs->viewport_set_disable_3d(this->viewport, SUBVIEWPORT_DISABLE_3D_FLAG);
+    rs->viewport_set_clear_mode(this->viewport, RenderingServer::VIEWPORT_CLEAR_ALWAYS);
+    // only rendered once for every update that changed the model
+    rs->viewport_set_update_mode(this->viewport, RenderingServer::VIEWPORT_UPDATE_ONCE);
+    rs->viewport_set_transparent_background(this->viewport, true);
+    rs->viewport_set_size(this->viewport, this->render_size.x, this->render_size.y);
+    rs->viewport_set_active(this->viewport, true);
+
+    this->canvas = rs->canvas_create();
+    rs->viewport_attach_canvas(this->viewport, this->canvas);
+
+    this->root = rs->canvas_item_create();
+    rs->canvas_item_set_parent(this->root, this->canvas);
+}
+
+
+GDCubismModelTexture::~GDCubismModelTexture() {
+    GDCubismUserModel *model = this->get_model_ptr();
+    if(model != nullptr) model->_on_detach_texture(this);
+
+    this->release_items();
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    rs->free_rid(this->root);
+    rs->free_rid(this->viewport);
+    rs->free_rid(this->canvas);
+}
+
+
+void GDCubismModelTexture::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_model", "model"), &GDCubismModelTexture::set_model);
+    ClassDB::bind_method(D_METHOD("get_model"), &GDCubismModelTexture::get_model);
+
+    ClassDB::bind_method(D_METHOD("set_render_size", "value"), &GDCubismModelTexture::set_render_size);
+    ClassDB::bind_method(D_METHOD("get_render_size"), &GDCubismModelTexture::get_render_size);
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "render_size"), "set_render_size", "get_render_size");
+}
+
+
+GDCubismUserModel *GDCubismModelTexture::get_model_ptr() const {
+    if(this->model_id.is_valid() == false) return nullptr;
+    return Object::cast_to<GDCubismUserModel>(ObjectDB::get_instance(this->model_id));
+}
+
+
+void GDCubismModelTexture::update_root(InternalCubismUserModel *model) {
+    // the whole model canvas is fit into the texture, centered and keeping its aspect
+    const Rect2 rect = model->mirror_rect();
+    if(rect.size.x <= 0.0 || rect.size.y <= 0.0) return;
+
+    const Vector2 size(this->render_size);
+    const real_t scale = MIN(size.x / rect.size.x, size.y / rect.size.y);
+    const Vector2 offset = (size - rect.size * scale) * 0.5 - rect.position * scale;
+
+    RenderingServer::get_singleton()->canvas_item_set_transform(this->root, Transform2D(
+        Vector2(scale, 0.0),
+        Vector2(0.0, scale),
+        offset));
+}
+
+
+void GDCubismModelTexture::release_items() {
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    // children before their clip parents
+    for(Csm::csmInt32 i = Csm::csmInt32(this->items.GetSize()) - 1; i >= 0; i--) {
+        rs->free_rid(this->items[i]);
+    }
+    this->items.Clear();
+    this->items_dirty = true;
+}
+
+
+void GDCubismModelTexture::refresh(InternalCubismUserModel *model, const bool structure_changed) {
+    // vertices, colors and masks reach the copies through the meshes and materials they share
+    // with the model, only visibility and order changes need new copies
+    if(structure_changed == true || this->items_dirty == true) {
+        this->release_items();
+        model->mirror_build(this->root, this->items);
+        this->update_root(model);
+        this->items_dirty = false;
+    }
+
+    RenderingServer::get_singleton()->viewport_set_update_mode(this->viewport, RenderingServer::VIEWPORT_UPDATE_ONCE);
+}
+
+
+void GDCubismModelTexture::detach() {
+    this->release_items();
+    this->model_id = ObjectID();
+    RenderingServer::get_singleton()->viewport_set_update_mode(this->viewport, RenderingServer::VIEWPORT_UPDATE_ONCE);
+}
+
+
+void GDCubismModelTexture::set_model(GDCubismUserModel *model) {
+    GDCubismUserModel *current = this->get_model_ptr();
+    if(current == model) return;
+
+    if(current != nullptr) current->_on_detach_texture(this);
+    this->detach();
+
+    if(model != nullptr) {
+        this->model_id = ObjectID(model->get_instance_id());
+        model->_on_attach_texture(this);
+    }
+}
+
+
+GDCubismUserModel *GDCubismModelTexture::get_model() const {
+    return this->get_model_ptr();
+}
+
+
+void GDCubismModelTexture::set_render_size(const Vector2i value) {
+    const Vector2i size(MAX(1, value.x), MAX(1, value.y));
+    if(this->render_size == size) return;
+    this->render_size = size;
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    rs->viewport_set_size(this->viewport, size.x, size.y);
+    // the copies are kept, only the fit into the texture changes
+    GDCubismUserModel *model = this->get_model_ptr();
+    if(model != nullptr && model->is_initialized() == true) this->update_root(model->internal_model);
+    rs->viewport_set_update_mode(this->viewport, RenderingServer::VIEWPORT_UPDATE_ONCE);
+
+    this->emit_changed();
+}
+
+
+RID GDCubismModelTexture::_get_rid() const {
+    return RenderingServer::get_singleton()->viewport_get_texture(this->viewport);
+}
+
+
+// ------------------------------------------------------------------ method(s)
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef GD_CUBISM_MODEL_TEXTURE_H
+#define GD_CUBISM_MODEL_TEXTURE_H
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/texture2d.hpp>
+#include <godot_cpp/core/object_id.hpp>
+
+#include <Type/csmVector.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+class GDCubismUserModel;
+class InternalCubismUserModel;
+
+
+// ------------------------------------------------------------------- class(s)
+class GDCubismModelTexture : public Texture2D {
+    GDCLASS(GDCubismModelTexture, Texture2D)
+    friend GDCubismUserModel;
+
+public:
+    GDCubismModelTexture();
+    ~GDCubismModelTexture();
+
+protected:
+    static void _bind_methods();
+
+private:
+    Vector2i render_size;
+    // the model only knows the texture by pointer, the texture holds the model by id
+    ObjectID model_id;
+
+    RID viewport;
+    RID canvas;
+    RID root;
+    Csm::csmVector<RID> items;
+    // copies are built again on the next refresh, not only when the model says its drawables regrouped
+    bool items_dirty;
+
+private:
+    GDCubismUserModel *get_model_ptr() const;
+    void update_root(InternalCubismUserModel *model);
+    void release_items();
+    // called by the model
+    void refresh(InternalCubismUserModel *model, const bool structure_changed);
+    void detach();
+
+public:
+    void set_model(GDCubismUserModel *model);
+    GDCubismUserModel *get_model() const;
+
+    void set_render_size(const Vector2i value);
+    Vector2i get_render_size() const { return this->render_size; }
+
+    int32_t _get_width() const override { return this->render_size.x; }
+    int32_t _get_height() const override { return this->render_size.y; }
+    bool _has_alpha() const override { return true; }
+    RID _get_rid() const override;
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // GD_CUBISM_MODEL_TEXTURE_H
@@ -3,15 +3,21 @@
 // ----------------------------------------------------------------- include(s)
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/object.hpp>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/ref.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
 #include <godot_cpp/classes/sprite2d.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/window.hpp>
 
 #include <CubismFramework.hpp>
 #include <Model/CubismModel.hpp>
 #include <Motion/CubismMotion.hpp>
 
+#include <private/internal_cubism_load_request.hpp>
+#include <private/internal_cubism_mask_budget.hpp>
+#include <private/internal_cubism_model_data.hpp>
 #include <private/internal_cubism_user_model.hpp>
 #include <gd_cubism_effect_eye_blink.hpp>
 #include <gd_cubism_motion_entry.hpp>
@@ -34,12 +40,33 @@ GDCubismUserModel::GDCubismUserModel()
     : internal_model(nullptr)
     , enable_load_expressions(true)
     , enable_load_motions(true)
+    , load_async(false)
+    , load_time_slice(2.0)
+    , load_next(nullptr)
+    , load_progress(0.0)
     , speed_scale(1.0)
     , mask_viewport_size(0)
+    , mask_importance(1.0)
     , parameter_mode(ParameterMode::FULL_PARAMETER)
     , physics_evaluate(true)
     , pose_update(true)
     , playback_process_mode(MotionProcessCallback::IDLE)
+    , rendering_backend(RenderingBackend::RENDERING_BACKEND_NODE)
+    , batching(false)
+    , mask_mode(MaskMode::MASK_MODE_VIEWPORT)
+    , cull_mode(CullMode::CULL_MODE_DISABLED)
+    , cull_margin(64.0)
+    , cull_throttle_interval(0.25)
+    , simulation_rate(0.0)
+    , simulation_interpolation(true)
+    , impostor(false)
+    , impostor_delay(0.5)
+    , impostor_idle(0.0)
+    , impostor_wake(false)
+    , culled(false)
+    , cull_bounds_elapsed(0.0)
+    , lod_level(-1)
+    , pending_delta(0.0)
     , anim_loop(DEFAULT_PROP_ANIM_LOOP)
     , anim_loop_fade_in(DEFAULT_PROP_ANIM_LOOP_FADE_IN)
     , cubism_effect_dirty(false) {
@@ -73,6 +100,18 @@ void GDCubismUserModel::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_load_motions"), &GDCubismUserModel::get_load_motions);
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "load_motions"), "set_load_motions", "get_load_motions");
 
+    // Asynchronous Load
+    ClassDB::bind_method(D_METHOD("set_load_async", "enable"), &GDCubismUserModel::set_load_async);
+    ClassDB::bind_method(D_METHOD("get_load_async"), &GDCubismUserModel::get_load_async);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "load_async"), "set_load_async", "get_load_async");
+
+    ClassDB::bind_method(D_METHOD("set_load_time_slice", "value"), &GDCubismUserModel::set_load_time_slice);
+    ClassDB::bind_method(D_METHOD("get_load_time_slice"), &GDCubismUserModel::get_load_time_slice);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "load_time_slice", PROPERTY_HINT_RANGE, "0.1,100.0,0.1,or_greater,suffix:ms"), "set_load_time_slice", "get_load_time_slice");
+
+    ClassDB::bind_method(D_METHOD("is_loading"), &GDCubismUserModel::is_loading);
+    ClassDB::bind_method(D_METHOD("get_load_progress"), &GDCubismUserModel::get_load_progress);
+
     ClassDB::bind_method(D_METHOD("get_canvas_info"), &GDCubismUserModel::get_canvas_info);
 
     ClassDB::bind_method(D_METHOD("set_parameter_mode", "value"), &GDCubismUserModel::set_parameter_mode);
@@ -91,14 +130,73 @@ void GDCubismUserModel::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_process_callback"), &GDCubismUserModel::get_process_callback);
     ADD_PROPERTY(PropertyInfo(Variant::INT, "playback_process_mode", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_process_callback", "get_process_callback");
 
+    ClassDB::bind_method(D_METHOD("set_rendering_backend", "value"), &GDCubismUserModel::set_rendering_backend);
+    ClassDB::bind_method(D_METHOD("get_rendering_backend"), &GDCubismUserModel::get_rendering_backend);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "rendering_backend", PROPERTY_HINT_ENUM, "Node,RenderingServer"), "set_rendering_backend", "get_rendering_backend");
+
+    ClassDB::bind_method(D_METHOD("set_batching", "enable"), &GDCubismUserModel::set_batching);
+    ClassDB::bind_method(D_METHOD("get_batching"), &GDCubismUserModel::get_batching);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batching"), "set_batching", "get_batching");
+
     ClassDB::bind_method(D_METHOD("set_speed_scale", "value"), &GDCubismUserModel::set_speed_scale);
     ClassDB::bind_method(D_METHOD("get_speed_scale"), &GDCubismUserModel::get_speed_scale);
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "speed_scale", PROPERTY_HINT_RANGE, "0.0,256.0,0.1"), "set_speed_scale", "get_speed_scale");
 
+    ClassDB::bind_method(D_METHOD("set_simulation_rate", "value"), &GDCubismUserModel::set_simulation_rate);
+    ClassDB::bind_method(D_METHOD("get_simulation_rate"), &GDCubismUserModel::get_simulation_rate);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "simulation_rate", PROPERTY_HINT_RANGE, "0.0,240.0,1.0"), "set_simulation_rate", "get_simulation_rate");
+
+    ClassDB::bind_method(D_METHOD("set_simulation_interpolation", "enable"), &GDCubismUserModel::set_simulation_interpolation);
+    ClassDB::bind_method(D_METHOD("get_simulation_interpolation"), &GDCubismUserModel::get_simulation_interpolation);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "simulation_interpolation"), "set_simulation_interpolation", "get_simulation_interpolation");
+
     ClassDB::bind_method(D_METHOD("set_mask_viewport_size", "value"), &GDCubismUserModel::set_mask_viewport_size);
     ClassDB::bind_method(D_METHOD("get_mask_viewport_size"), &GDCubismUserModel::get_mask_viewport_size);
     ADD_PROPERTY(PropertyInfo(Variant::INT, "mask_viewport_size", PROPERTY_HINT_RANGE, "0, 4096"), "set_mask_viewport_size", "get_mask_viewport_size");
 
+    ClassDB::bind_method(D_METHOD("set_mask_mode", "value"), &GDCubismUserModel::set_mask_mode);
+    ClassDB::bind_method(D_METHOD("get_mask_mode"), &GDCubismUserModel::get_mask_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "mask_mode", PROPERTY_HINT_ENUM, "Viewport,Atlas,ClipChildren"), "set_mask_mode", "get_mask_mode");
+
+    ClassDB::bind_method(D_METHOD("set_mask_importance", "value"), &GDCubismUserModel::set_mask_importance);
+    ClassDB::bind_method(D_METHOD("get_mask_importance"), &GDCubismUserModel::get_mask_importance);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "mask_importance", PROPERTY_HINT_RANGE, "0.0,16.0,0.1"), "set_mask_importance", "get_mask_importance");
+
+    ClassDB::bind_method(D_METHOD("set_cull_mode", "value"), &GDCubismUserModel::set_cull_mode);
+    ClassDB::bind_method(D_METHOD("get_cull_mode"), &GDCubismUserModel::get_cull_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "cull_mode", PROPERTY_HINT_ENUM, "Disabled,Render,Throttle,Freeze"), "set_cull_mode", "get_cull_mode");
+
+    ClassDB::bind_method(D_METHOD("set_cull_margin", "value"), &GDCubismUserModel::set_cull_margin);
+    ClassDB::bind_method(D_METHOD("get_cull_margin"), &GDCubismUserModel::get_cull_margin);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cull_margin", PROPERTY_HINT_RANGE, "0.0,1024.0,1.0,or_greater"), "set_cull_margin", "get_cull_margin");
+
+    ClassDB::bind_method(D_METHOD("set_cull_throttle_interval", "value"), &GDCubismUserModel::set_cull_throttle_interval);
+    ClassDB::bind_method(D_METHOD("get_cull_throttle_interval"), &GDCubismUserModel::get_cull_throttle_interval);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cull_throttle_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.01"), "set_cull_throttle_interval", "get_cull_throttle_interval");
+
+    ClassDB::bind_method(D_METHOD("is_culled"), &GDCubismUserModel::is_culled);
+
+    ClassDB::bind_method(D_METHOD("set_impostor", "enable"), &GDCubismUserModel::set_impostor);
+    ClassDB::bind_method(D_METHOD("get_impostor"), &GDCubismUserModel::get_impostor);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "impostor"), "set_impostor", "get_impostor");
+
+    ClassDB::bind_method(D_METHOD("set_impostor_delay", "value"), &GDCubismUserModel::set_impostor_delay);
+    ClassDB::bind_method(D_METHOD("get_impostor_delay"), &GDCubismUserModel::get_impostor_delay);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "impostor_delay", PROPERTY_HINT_RANGE, "0.0,10.0,0.01"), "set_impostor_delay", "get_impostor_delay");
+
+    ClassDB::bind_method(D_METHOD("is_impostor_active"), &GDCubismUserModel::is_impostor_active);
+
+    ClassDB::bind_method(D_METHOD("set_lod_levels", "levels"), &GDCubismUserModel::set_lod_levels);
+    ClassDB::bind_method(D_METHOD("get_lod_levels"), &GDCubismUserModel::get_lod_levels);
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "lod_levels", PROPERTY_HINT_TYPE_STRING, vformat("%d/%d:%s", Variant::OBJECT, PROPERTY_HINT_RESOURCE_TYPE, "GDCubismLevelOfDetail")), "set_lod_levels", "get_lod_levels");
+
+    ClassDB::bind_method(D_METHOD("get_lod_level"), &GDCubismUserModel::get_lod_level);
+
+    // MaskBudget, shared by every model
+    ClassDB::bind_static_method("GDCubismUserModel", D_METHOD("set_mask_texel_budget", "texels"), &GDCubismUserModel::set_mask_texel_budget);
+    ClassDB::bind_static_method("GDCubismUserModel", D_METHOD("get_mask_texel_budget"), &GDCubismUserModel::get_mask_texel_budget);
+    ClassDB::bind_static_method("GDCubismUserModel", D_METHOD("get_mask_texel_usage"), &GDCubismUserModel::get_mask_texel_usage);
+
     ClassDB::bind_method(D_METHOD("set_shader_add"), &GDCubismUserModel::set_shader_add);
     ClassDB::bind_method(D_METHOD("get_shader_add"), &GDCubismUserModel::get_shader_add);
     ClassDB::bind_method(D_METHOD("set_shader_mix"), &GDCubismUserModel::set_shader_mix);
@@ -163,6 +261,8 @@ void GDCubismUserModel::_bind_methods() {
     ClassDB::bind_method(D_METHOD("advance", "delta"), &GDCubismUserModel::advance);
 
     ADD_SIGNAL(MethodInfo("motion_event", PropertyInfo(Variant::STRING, "value")));
+    ADD_SIGNAL(MethodInfo(SIGNAL_LOD_CHANGED, PropertyInfo(Variant::INT, "level")));
+    ADD_SIGNAL(MethodInfo(SIGNAL_MODEL_LOADED));
     #ifdef CUBISM_MOTION_CUSTOMDATA
     ADD_SIGNAL(MethodInfo(SIGNAL_MOTION_FINISHED));
     #endif // #ifdef CUBISM_MOTION_CUSTOMDATA
@@ -189,13 +289,37 @@ void GDCubismUserModel::_bind_methods() {
     BIND_ENUM_CONSTANT(PHYSICS);
     BIND_ENUM_CONSTANT(IDLE);
     BIND_ENUM_CONSTANT(MANUAL);
+
+    // RenderingBackend
+    BIND_ENUM_CONSTANT(RENDERING_BACKEND_NODE);
+    BIND_ENUM_CONSTANT(RENDERING_BACKEND_SERVER);
+
+    // MaskMode
+    BIND_ENUM_CONSTANT(MASK_MODE_VIEWPORT);
+    BIND_ENUM_CONSTANT(MASK_MODE_ATLAS);
+    BIND_ENUM_CONSTANT(MASK_MODE_CLIP_CHILDREN);
+
+    // CullMode
+    BIND_ENUM_CONSTANT(CULL_MODE_DISABLED);
+    BIND_ENUM_CONSTANT(CULL_MODE_RENDER);
+    BIND_ENUM_CONSTANT(CULL_MODE_THROTTLE);
+    BIND_ENUM_CONSTANT(CULL_MODE_FREEZE);
 }
 
 
 void GDCubismUserModel::_notification(int p_what) {
     if (p_what == NOTIFICATION_PREDELETE) {
+        this->cancel_load();
         this->clear();
         this->ary_shader.clear();
+        for(Csm::csmUint32 i = 0; i < this->_list_model_texture.GetSize(); i++) {
+            this->_list_model_texture[i]->detach();
+        }
+        this->_list_model_texture.Clear();
+        for(Csm::csmUint32 i = 0; i < this->_list_model_3d.GetSize(); i++) {
+            this->_list_model_3d[i]->detach();
+        }
+        this->_list_model_3d.Clear();
     }
 }
 
@@ -288,6 +412,86 @@ GDCubismUserModel::MotionProcessCallback GDCubismUserModel::get_process_callback
 }
 
 
+void GDCubismUserModel::set_rendering_backend(const RenderingBackend value) {
+    if(this->rendering_backend == value) return;
+    // the clipped drawables are parented to their mask's canvas item, which nodes cannot follow
+    ERR_FAIL_COND_MSG(
+        value == RENDERING_BACKEND_NODE && this->mask_mode == MASK_MODE_CLIP_CHILDREN,
+        "GDCubismUserModel: mask_mode MASK_MODE_CLIP_CHILDREN requires RENDERING_BACKEND_SERVER."
+    );
+    this->rendering_backend = value;
+
+    // drawables are built for one backend only, rebuild them when a model is already loaded
+    if(this->is_initialized() == true) {
+        this->load_model(this->assets);
+    }
+}
+
+
+GDCubismUserModel::RenderingBackend GDCubismUserModel::get_rendering_backend() const {
+    return this->rendering_backend;
+}
+
+
+void GDCubismUserModel::set_batching(const bool enable) {
+    if(this->batching == enable) return;
+    this->batching = enable;
+
+    if(this->is_initialized() == true) {
+        this->load_model(this->assets);
+    }
+}
+
+
+bool GDCubismUserModel::get_batching() const {
+    return this->batching;
+}
+
+
+void GDCubismUserModel::set_mask_mode(const MaskMode value) {
+    if(this->mask_mode == value) return;
+    this->mask_mode = value;
+
+    // clip children only works on bare canvas items, switch the backend along so it reports what is drawn
+    if(value == MASK_MODE_CLIP_CHILDREN && this->rendering_backend == RENDERING_BACKEND_NODE) {
+        this->rendering_backend = RENDERING_BACKEND_SERVER;
+        this->notify_property_list_changed();
+    }
+
+    // mask targets are laid out for one mode only
+    if(this->is_initialized() == true) {
+        this->load_model(this->assets);
+    }
+}
+
+
+GDCubismUserModel::MaskMode GDCubismUserModel::get_mask_mode() const {
+    return this->mask_mode;
+}
+
+
+GDCubismUserModel::MaskMode GDCubismUserModel::get_mask_mode_built() const {
+    // the 3D meshes read the masks from textures, which clip_children never renders
+    if(this->mask_mode == MASK_MODE_CLIP_CHILDREN && this->_list_model_3d.GetSize() > 0) return MASK_MODE_VIEWPORT;
+    return this->mask_mode;
+}
+
+
+void GDCubismUserModel::set_mask_texel_budget(const int64_t texels) {
+    InternalCubismMaskBudget::set_budget(texels);
+}
+
+
+int64_t GDCubismUserModel::get_mask_texel_budget() {
+    return InternalCubismMaskBudget::get_budget();
+}
+
+
+int64_t GDCubismUserModel::get_mask_texel_usage() {
+    return InternalCubismMaskBudget::get_usage();
+}
+
+
 void GDCubismUserModel::set_speed_scale(const float speed) {
     this->speed_scale = CLAMP<float, float, float>(speed, 0.0, 256.0);
 }
@@ -327,6 +531,7 @@ Ref<GDCubismMotionQueueEntryHandle> GDCubismUserModel::start_motion_loop(const S
 
     if(this->is_initialized() == false) return queue_handle;
 
+    this->impostor_wake = true;
     queue_handle->_handle = this->internal_model->motion_start(
         str_group.utf8().ptr(),
         no,
@@ -362,6 +567,7 @@ Array GDCubismUserModel::get_cubism_motion_queue_entries() const {
 void GDCubismUserModel::stop_motion() {
     if(this->is_initialized() == false) return;
 
+    this->impostor_wake = true;
     this->internal_model->motion_stop();
 }
 
@@ -387,6 +593,7 @@ Array GDCubismUserModel::get_expressions() const {
 void GDCubismUserModel::start_expression(const String str_expression_id) {
     if(this->is_initialized() == false) return;
 
+    this->impostor_wake = true;
     this->internal_model->expression_set(str_expression_id.utf8().ptr());
 }
 
@@ -394,6 +601,7 @@ void GDCubismUserModel::start_expression(const String str_expression_id) {
 void GDCubismUserModel::stop_expression() {
     if(this->is_initialized() == false) return;
 
+    this->impostor_wake = true;
     this->internal_model->expression_stop();
 }
 
@@ -436,6 +644,8 @@ Array GDCubismUserModel::get_part_opacities() const {
 Dictionary GDCubismUserModel::get_meshes() const {
     ERR_FAIL_COND_V(this->is_initialized() == false, Dictionary());
 
+    // a node a script holds on to must not turn up in another model
+    this->internal_model->_renderer_resource.meshes_exposed = true;
     return this->internal_model->_renderer_resource.dict_mesh;
 }
 
@@ -450,11 +660,170 @@ void GDCubismUserModel::on_motion_finished(Csm::ACubismMotion* motion) {
 }
 
 
+void GDCubismUserModel::set_lod_levels(const TypedArray<GDCubismLevelOfDetail> &levels) {
+    this->lod_levels = levels;
+    // the level is picked again from scratch on the next update
+    this->lod_level = -1;
+}
+
+
+int32_t GDCubismUserModel::select_lod_level(const Rect2 &bounds_in_viewport) const {
+    const float screen_size = MAX(bounds_in_viewport.size.x, bounds_in_viewport.size.y);
+
+    // the coarsest level the model is still small enough for wins
+    int32_t selected = -1;
+    float selected_size = 0.0;
+    for(int32_t index = 0; index < this->lod_levels.size(); index++) {
+        Ref<GDCubismLevelOfDetail> level = this->lod_levels[index];
+        if(level.is_null() == true) continue;
+
+        const float threshold = index == this->lod_level ? level->screen_size * LOD_HYSTERESIS : level->screen_size;
+        if(screen_size > threshold) continue;
+        if(selected < 0 || level->screen_size < selected_size) {
+            selected = index;
+            selected_size = level->screen_size;
+        }
+    }
+
+    return selected;
+}
+
+
+void GDCubismUserModel::update_screen_state() {
+    InternalCubismRendererResource &res = this->internal_model->_renderer_resource;
+
+    // the bounds are cached by the last rendered update, a model that was never drawn is kept at full detail
+    bool culled = false;
+    int32_t lod_level = -1;
+    Transform2D canvas_transform;
+    if(res.has_model_bounds == true) {
+        canvas_transform = this->get_global_transform_with_canvas();
+        const Rect2 bounds_in_viewport = canvas_transform.xform(res.model_bounds);
+
+        // never cull while looking at the model in the editor, or while it is shown elsewhere
+        if(
+            this->cull_mode != CULL_MODE_DISABLED &&
+            this->has_mirror() == false &&
+            Engine::get_singleton()->is_editor_hint() == false
+        ) {
+            culled = this->get_viewport_rect().intersects(bounds_in_viewport.grow(this->cull_margin)) == false;
+        }
+        lod_level = this->select_lod_level(bounds_in_viewport);
+    }
+    // a culled model does not draw its masks, its share of the budget goes to the models on screen
+    if(culled == true && this->culled == false) InternalCubismMaskBudget::suspend(&res);
+    this->culled = culled;
+
+    if(this->lod_level != lod_level) {
+        this->lod_level = lod_level;
+        this->emit_signal(SIGNAL_LOD_CHANGED, lod_level);
+    }
+
+    // the renderer works in model units, the area cutoff is converted with the current scale
+    Ref<GDCubismLevelOfDetail> level;
+    if(this->lod_level >= 0) level = this->lod_levels[this->lod_level];
+    if(level.is_valid() == true) {
+        const float area_scale = Math::abs(canvas_transform.determinant());
+        res.lod_area_min = area_scale > 0.0f ? level->drawable_area_min / area_scale : 0.0f;
+        res.lod_mask_scale = CLAMP(level->mask_scale, 0.0f, 1.0f);
+    } else {
+        res.lod_area_min = 0.0f;
+        res.lod_mask_scale = 1.0f;
+    }
+}
+
+
+bool GDCubismUserModel::is_impostor_active() const {
+    if(this->is_initialized() == false) return false;
+    return this->internal_model->_renderer_resource.impostor.active;
+}
+
+
+bool GDCubismUserModel::check_impostor_wake() const {
+    if(this->impostor_wake == true || this->cubism_effect_dirty == true) return true;
+
+    // values written from outside differ from the model until the next update applies them
+    for(Csm::csmInt32 index = 0; index < this->ary_parameter.size(); index++) {
+        Ref<GDCubismParameter> param = this->ary_parameter[index];
+        if(param.is_valid() == true && param->value != *param->raw_value) return true;
+    }
+    for(Csm::csmInt32 index = 0; index < this->ary_part_opacity.size(); index++) {
+        Ref<GDCubismPartOpacity> param = this->ary_part_opacity[index];
+        if(param.is_valid() == true && param->value != *param->raw_value) return true;
+    }
+
+    return false;
+}
+
+
+void GDCubismUserModel::update_impostor(const float delta) {
+    // a motion still playing may only be holding its pose for a moment
+    const bool settled =
+        this->internal_model->_renderer_resource.drawables_changed == false &&
+        this->internal_model->_motionManager->IsFinished() == true;
+
+    this->impostor_idle = settled == true ? this->impostor_idle + delta : 0.0f;
+    if(this->impostor_idle < this->impostor_delay) return;
+
+    const float scale = Math::sqrt(Math::abs(this->get_global_transform_with_canvas().determinant()));
+    if(this->internal_model->impostor_capture(scale) == true) {
+        this->impostor_wake = false;
+    }
+}
+
+
 void GDCubismUserModel::_update(const float delta) {
 
-    this->internal_model->pro_update(delta * this->speed_scale);
+    // nothing is evaluated behind an impostor until a motion, expression or value change arrives
+    if(this->is_impostor_active() == true) {
+        if(this->impostor == true && this->check_impostor_wake() == false) {
+            const float scale = Math::sqrt(Math::abs(this->get_global_transform_with_canvas().determinant()));
+            const float captured = this->internal_model->_renderer_resource.impostor.scale;
+            if(scale > captured * IMPOSTOR_RESCALE_RATIO || scale * IMPOSTOR_RESCALE_RATIO < captured) {
+                this->internal_model->impostor_capture(scale);
+            }
+            return;
+        }
+        this->internal_model->impostor_release();
+        this->impostor_idle = 0.0;
+    }
+
+    this->update_screen_state();
+
+    const float step = this->simulation_rate > 0.0 ? 1.0 / this->simulation_rate : 0.0;
+
+    float interval = step;
+    if(this->culled == true) {
+        if(this->cull_mode == CULL_MODE_FREEZE) return;
+        if(this->cull_mode == CULL_MODE_THROTTLE) interval = MAX(interval, this->cull_throttle_interval);
+    }
+    if(this->lod_level >= 0) {
+        Ref<GDCubismLevelOfDetail> level = this->lod_levels[this->lod_level];
+        if(level.is_valid() == true) interval = MAX(interval, level->update_interval);
+    }
+
+    // the pose is only blended while the simulation rate alone sets the interval,
+    // throttled and low detail models are meant to be drawn less often as well
+    InternalCubismRendererResource &res = this->internal_model->_renderer_resource;
+    res.use_interpolation = this->simulation_interpolation == true && step > 0.0 && interval == step;
+
+    // time held back is caught up by the next update that runs
+    this->pending_delta += delta;
+    if(this->pending_delta + UPDATE_INTERVAL_EPSILON < interval) {
+        if(res.use_interpolation == true && this->culled == false) {
+            res.interpolation_alpha = MIN(this->pending_delta / step, 1.0f);
+            this->update_node();
+        }
+        return;
+    }
+    const float sim_delta = this->pending_delta;
+    this->pending_delta = 0.0;
+    res.interpolation_step = true;
+    res.interpolation_alpha = 0.0;
+
+    this->internal_model->pro_update(sim_delta * this->speed_scale);
 
-    this->internal_model->efx_update(delta * this->speed_scale);
+    this->internal_model->efx_update(sim_delta * this->speed_scale);
 
     for(Csm::csmInt32 index = 0; index < this->ary_parameter.size(); index++ ) {
         Ref<GDCubismParameter> param = this->ary_parameter[index];
@@ -477,8 +846,28 @@ void GDCubismUserModel::_update(const float delta) {
         }
     }
 
-    this->internal_model->epi_update(delta * this->speed_scale);
+    this->internal_model->epi_update(sim_delta * this->speed_scale);
 
+    // dynamic flags keep accumulating while offscreen, the first visible update picks up everything.
+    // the bounds deciding that still have to follow the motion now and then
+    if(this->culled == true) {
+        this->cull_bounds_elapsed += sim_delta;
+        if(this->cull_bounds_elapsed >= CULL_BOUNDS_INTERVAL) {
+            this->cull_bounds_elapsed = 0.0;
+            this->internal_model->update_bounds();
+        }
+        return;
+    }
+    this->cull_bounds_elapsed = 0.0;
+
+    this->update_node();
+
+    // textures and 3D meshes draw the live drawables, the impostor would hide them
+    if(this->impostor == true && this->has_mirror() == false) this->update_impostor(sim_delta);
+}
+
+
+void GDCubismUserModel::update_node() {
     // https://github.com/godotengine/godot/issues/90030
     // https://github.com/godotengine/godot/issues/90017
     #ifdef COUNTERMEASURES_90017_90030
@@ -490,6 +879,26 @@ void GDCubismUserModel::_update(const float delta) {
     #else
     this->internal_model->update_node();
     #endif // COUNTERMEASURES_90017_90030
+
+    this->update_mirror();
+}
+
+
+void GDCubismUserModel::update_mirror() {
+    const InternalCubismRendererResource &res = this->internal_model->_renderer_resource;
+    if(res.drawables_changed == false) return;
+
+    for(Csm::csmUint32 i = 0; i < this->_list_model_texture.GetSize(); i++) {
+        this->_list_model_texture[i]->refresh(this->internal_model, res.structure_changed);
+    }
+    for(Csm::csmUint32 i = 0; i < this->_list_model_3d.GetSize(); i++) {
+        this->_list_model_3d[i]->refresh(this->internal_model, res.structure_changed);
+    }
+}
+
+
+bool GDCubismUserModel::has_mirror() const {
+    return this->_list_model_texture.GetSize() > 0 || this->_list_model_3d.GetSize() > 0;
 }
 
 
@@ -761,31 +1170,73 @@ void GDCubismUserModel::clear() {
         return;
     }
 
+    // the copies drawn by the textures refer to meshes about to be freed
+    for(Csm::csmUint32 i = 0; i < this->_list_model_texture.GetSize(); i++) {
+        this->_list_model_texture[i]->release_items();
+    }
+    for(Csm::csmUint32 i = 0; i < this->_list_model_3d.GetSize(); i++) {
+        this->_list_model_3d[i]->release_items();
+    }
+
     this->internal_model->clear();
     CSM_DELETE(this->internal_model);
     this->internal_model = nullptr;
+    this->model_data.unref();
+    this->culled = false;
+    this->cull_bounds_elapsed = 0.0;
+    this->lod_level = -1;
+    this->pending_delta = 0.0;
+    this->impostor_idle = 0.0;
+    this->impostor_wake = false;
 }
 
 void GDCubismUserModel::load_model(const String assets) {
-    this->clear();
+    // a newer request replaces the one still running
+    this->cancel_load();
 
     if (assets.is_empty()) {
+        this->clear();
         return;
     }
 
     Ref<FileAccess> f = FileAccess::open(assets, FileAccess::READ);
+    if(f.is_null() == true) this->clear();
     ERR_FAIL_COND_MSG(f.is_null(), "Could not open model path.  Make sure to point to the model3.json");
 
-    this->internal_model = CSM_NEW InternalCubismUserModel(this);
+    if(this->load_async == true) {
+        this->start_load(assets);
+        return;
+    }
 
-    if(
-        this->internal_model->model_load(assets) == false ||
-        this->internal_model->IsInitialized() == false
-    ) { 
+    // the files are read once and shared by every model using them as long as one holds on to them
+    Ref<GDCubismModelData> res = ResourceLoader::get_singleton()->load(assets, "GDCubismModelData");
+    InternalCubismModelData data;
+    if(res.is_null() == true || data.revive(*res->data) == false) {
         this->clear();
-        return; 
+        return;
     }
 
+    if(this->swap_model(data) == false) {
+        this->clear();
+
+        this->internal_model = CSM_NEW InternalCubismUserModel(this);
+
+        if(
+            this->internal_model->model_load(data) == false ||
+            this->internal_model->IsInitialized() == false
+        ) { 
+            this->clear();
+            return; 
+        }
+
+        this->internal_model->build(false);
+    }
+
+    this->model_data = res;
+    this->setup_model();
+}
+
+void GDCubismUserModel::setup_model() {
     Csm::CubismModel *model = this->internal_model->GetModel();
 
     {
@@ -811,11 +1262,132 @@ void GDCubismUserModel::load_model(const String assets) {
     }
 
     this->cubism_effect_dirty = true;
+    this->internal_model->_renderer_resource.use_mirrors = this->has_mirror();
   
     this->setup_property();
     this->notify_property_list_changed();
 }
 
+bool GDCubismUserModel::swap_model(InternalCubismModelData &data) {
+    if(this->internal_model == nullptr || this->internal_model->IsInitialized() == false) return false;
+
+    // the copies are rebuilt from the swapped model with the next update
+    for(Csm::csmUint32 i = 0; i < this->_list_model_texture.GetSize(); i++) {
+        this->_list_model_texture[i]->release_items();
+    }
+    for(Csm::csmUint32 i = 0; i < this->_list_model_3d.GetSize(); i++) {
+        this->_list_model_3d[i]->release_items();
+    }
+
+    if(this->internal_model->model_swap(data) == true) {
+        this->impostor_idle = 0.0;
+        this->impostor_wake = false;
+        return true;
+    }
+
+    return false;
+}
+
+void GDCubismUserModel::start_load(const String &assets) {
+    // models requesting the same file share one request, and the cache once it is done
+    const Error err = InternalCubismLoadRequest::request(assets);
+    ERR_FAIL_COND_MSG(err != OK, "Could not request model: " + assets);
+
+    this->load_path = assets;
+    this->load_progress = 0.0;
+}
+
+void GDCubismUserModel::update_load() {
+    if(this->load_path.is_empty() == false) {
+        ResourceLoader *res_loader = ResourceLoader::get_singleton();
+
+        Array progress;
+        if(res_loader->load_threaded_get_status(this->load_path, progress) == ResourceLoader::THREAD_LOAD_IN_PROGRESS) {
+            if(progress.size() > 0) this->load_progress = float(progress[0]) * LOAD_PROGRESS_READ;
+            return;
+        }
+
+        const String model_pathname = this->load_path;
+        Ref<GDCubismModelData> res = res_loader->load_threaded_get(model_pathname);
+        this->load_path = String();
+
+        // the setting, moc, files and textures are shared, only the model itself is made from them
+        InternalCubismModelData data;
+        if(res.is_null() == true || data.revive(*res->data) == false) {
+            this->clear();
+            ERR_FAIL_MSG("Could not load model: " + model_pathname);
+        }
+
+        if(this->swap_model(data) == true) {
+            this->model_data = res;
+            this->finish_load();
+            return;
+        }
+
+        // the model, its motions, physics and pose register their ids, which is left to the main thread
+        this->load_next = CSM_NEW InternalCubismUserModel(this);
+        if(
+            this->load_next->model_load(data) == false ||
+            this->load_next->IsInitialized() == false
+        ) {
+            this->cancel_load();
+            this->clear();
+            ERR_FAIL_MSG("Could not load model: " + model_pathname);
+        }
+        this->load_next_data = res;
+
+        // built hidden next to the current model, which keeps being drawn until the new one is done
+        this->load_next->build_begin(true);
+    }
+
+    if(this->load_next == nullptr) return;
+
+    Time *time = Time::get_singleton();
+    const uint64_t deadline = time->get_ticks_usec() + uint64_t(MAX(this->load_time_slice, 0.0f) * 1000.0f);
+
+    bool done = false;
+    do {
+        done = this->load_next->build_step();
+    } while(done == false && time->get_ticks_usec() < deadline);
+
+    this->load_progress = LOAD_PROGRESS_READ + (1.0f - LOAD_PROGRESS_READ) * this->load_next->get_build_progress();
+    if(done == false) return;
+
+    // the old drawables go now, the new nodes take over their names
+    this->clear();
+    this->internal_model = this->load_next;
+    this->model_data = this->load_next_data;
+    this->load_next = nullptr;
+    this->load_next_data.unref();
+    this->internal_model->_renderer_resource.restore_node_names();
+    this->finish_load();
+}
+
+void GDCubismUserModel::finish_load() {
+    this->load_progress = 1.0;
+    this->setup_model();
+    this->emit_signal(SIGNAL_MODEL_LOADED);
+}
+
+void GDCubismUserModel::cancel_load() {
+    // fetching a running request would wait for it, it is left to end on its own and then dropped
+    if(this->load_path.is_empty() == false) {
+        InternalCubismLoadRequest::abandon(this->load_path);
+        this->load_path = String();
+    }
+
+    if(this->load_next != nullptr) {
+        this->load_next->clear();
+        CSM_DELETE(this->load_next);
+        this->load_next = nullptr;
+        this->load_next_data.unref();
+    }
+}
+
+bool GDCubismUserModel::is_loading() const {
+    return this->load_path.is_empty() == false || this->load_next != nullptr;
+}
+
 void GDCubismUserModel::_ready() {
     if (!this->assets.is_empty()) {
         this->load_model(this->assets);
@@ -834,6 +1406,8 @@ void GDCubismUserModel::_exit_tree() {
 
 
 void GDCubismUserModel::_process(double delta) {
+    if(this->is_loading() == true) this->update_load();
+
     if(this->is_initialized() == false) return;
     if(this->playback_process_mode != IDLE) return;
 
@@ -863,4 +1437,65 @@ void GDCubismUserModel::_on_remove_child_act(GDCubismEffect* node) {
 }
 
 
+void GDCubismUserModel::_on_attach_texture(GDCubismModelTexture* texture) {
+    this->_list_model_texture.PushBack(texture);
+    if(this->is_initialized() == false) return;
+
+    this->internal_model->_renderer_resource.use_mirrors = true;
+    // the impostor hides the drawables the texture is about to copy
+    if(this->is_impostor_active() == true) {
+        this->internal_model->impostor_release();
+        this->impostor_idle = 0.0;
+    }
+    texture->refresh(this->internal_model, true);
+}
+
+
+void GDCubismUserModel::_on_detach_texture(GDCubismModelTexture* texture) {
+    for(Csm::csmVector<GDCubismModelTexture*>::iterator i = this->_list_model_texture.Begin(); i != this->_list_model_texture.End(); i++) {
+        if(*i == texture) { this->_list_model_texture.Erase(i); break; }
+    }
+    if(this->is_initialized() == false) return;
+
+    this->internal_model->_renderer_resource.use_mirrors = this->has_mirror();
+}
+
+
+void GDCubismUserModel::_on_attach_model_3d(GDCubismModel3D* node) {
+    const MaskMode built = this->get_mask_mode_built();
+    this->_list_model_3d.PushBack(node);
+    if(this->is_initialized() == false) return;
+
+    // the masks move to textures, the 3D mesh is built along with the next update
+    if(built != this->get_mask_mode_built()) {
+        this->load_model(this->assets);
+        return;
+    }
+
+    this->internal_model->_renderer_resource.use_mirrors = true;
+    if(this->is_impostor_active() == true) {
+        this->internal_model->impostor_release();
+        this->impostor_idle = 0.0;
+    }
+    node->refresh(this->internal_model, true);
+}
+
+
+void GDCubismUserModel::_on_detach_model_3d(GDCubismModel3D* node) {
+    const MaskMode built = this->get_mask_mode_built();
+    for(Csm::csmVector<GDCubismModel3D*>::iterator i = this->_list_model_3d.Begin(); i != this->_list_model_3d.End(); i++) {
+        if(*i == node) { this->_list_model_3d.Erase(i); break; }
+    }
+    if(this->is_initialized() == false) return;
+
+    // back to clip_children once no 3D mesh samples the mask textures
+    if(built != this->get_mask_mode_built()) {
+        this->load_model(this->assets);
+        return;
+    }
+
+    this->internal_model->_renderer_resource.use_mirrors = this->has_mirror();
+}
+
+
 // ------------------------------------------------------------------ method(s)
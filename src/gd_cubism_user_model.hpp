@@ -18,6 +18,10 @@
 #include <Motion/CubismMotionQueueEntry.hpp>
 
 #include <gd_cubism_effect.hpp>
+#include <gd_cubism_level_of_detail.hpp>
+#include <gd_cubism_model_3d.hpp>
+#include <gd_cubism_model_data.hpp>
+#include <gd_cubism_model_texture.hpp>
 #include <gd_cubism_motion_entry.hpp>
 
 
@@ -28,6 +32,7 @@
 // ------------------------------------------------------------------ static(s)
 // ----------------------------------------------------------- class:forward(s)
 class InternalCubismUserModel;
+class InternalCubismModelData;
 class GDCubismEffect;
 
 
@@ -103,18 +108,67 @@ public:
         MANUAL = 2
     };
 
+    enum RenderingBackend {
+        RENDERING_BACKEND_NODE = 0,
+        RENDERING_BACKEND_SERVER = 1
+    };
+
+    enum MaskMode {
+        MASK_MODE_VIEWPORT = 0,
+        MASK_MODE_ATLAS = 1,
+        MASK_MODE_CLIP_CHILDREN = 2
+    };
+
+    enum CullMode {
+        CULL_MODE_DISABLED = 0,
+        CULL_MODE_RENDER = 1,
+        CULL_MODE_THROTTLE = 2,
+        CULL_MODE_FREEZE = 3
+    };
+
     String assets;
     InternalCubismUserModel *internal_model;
     bool enable_load_expressions;
     bool enable_load_motions;
+    bool load_async;
+    float load_time_slice;
+    // shared by every model loaded from the same file, held so the cache keeps it
+    Ref<GDCubismModelData> model_data;
+    // state of an asynchronous load: the threaded request of the file, then the model built hidden
+    // next to the current one, which is replaced once the build is done
+    String load_path;
+    InternalCubismUserModel *load_next;
+    Ref<GDCubismModelData> load_next_data;
+    float load_progress;
 
     float speed_scale;
     int32_t mask_viewport_size;
+    float mask_importance;
     
     ParameterMode parameter_mode;
     bool physics_evaluate;
     bool pose_update;
     MotionProcessCallback playback_process_mode;
+    RenderingBackend rendering_backend;
+    bool batching;
+    MaskMode mask_mode;
+    CullMode cull_mode;
+    float cull_margin;
+    float cull_throttle_interval;
+    float simulation_rate;
+    bool simulation_interpolation;
+    bool impostor;
+    float impostor_delay;
+    // seconds the drawables stayed unchanged, and a motion or expression call since the last capture
+    float impostor_idle;
+    bool impostor_wake;
+    TypedArray<GDCubismLevelOfDetail> lod_levels;
+    // state of the last update, simulation time held back by the throttle or the level of detail
+    bool culled;
+    // simulated time since the bounds of a culled model were refreshed
+    float cull_bounds_elapsed;
+    int32_t lod_level;
+    float pending_delta;
 
     Array ary_shader;
     Array ary_parameter;
@@ -129,6 +183,8 @@ public:
 
     Csm::csmVector<GDCubismEffect*> _list_cubism_effect;
     bool cubism_effect_dirty;
+    Csm::csmVector<GDCubismModelTexture*> _list_model_texture;
+    Csm::csmVector<GDCubismModel3D*> _list_model_3d;
 
 protected:
     static void _bind_methods();
@@ -136,7 +192,21 @@ protected:
 
 private:
     void load_model(const String asset_path);
+    // an outfit variant of the loaded moc keeps the nodes and materials, only the moc, textures and motions change
+    bool swap_model(InternalCubismModelData &data);
+    void setup_model();
+    void start_load(const String &assets);
+    void update_load();
+    void finish_load();
+    void cancel_load();
     void clear();
+    void update_screen_state();
+    void update_node();
+    void update_mirror();
+    bool has_mirror() const;
+    void update_impostor(const float delta);
+    bool check_impostor_wake() const;
+    int32_t select_lod_level(const Rect2 &bounds_in_viewport) const;
 
 public:
     Dictionary csm_get_version();
@@ -151,6 +221,15 @@ public:
     void set_load_motions(const bool enable);
     bool get_load_motions() const;
 
+    void set_load_async(const bool enable) { this->load_async = enable; }
+    bool get_load_async() const { return this->load_async; }
+
+    void set_load_time_slice(const float value) { this->load_time_slice = value; }
+    float get_load_time_slice() const { return this->load_time_slice; }
+
+    bool is_loading() const;
+    float get_load_progress() const { return this->load_progress; }
+
     Dictionary get_canvas_info() const;
 
     bool is_initialized() const;
@@ -167,6 +246,18 @@ public:
     void set_process_callback(const MotionProcessCallback value);
     GDCubismUserModel::MotionProcessCallback get_process_callback() const;
 
+    void set_rendering_backend(const RenderingBackend value);
+    GDCubismUserModel::RenderingBackend get_rendering_backend() const;
+
+    void set_batching(const bool enable);
+    bool get_batching() const;
+
+    void set_simulation_rate(const float value) { this->simulation_rate = value; }
+    float get_simulation_rate() const { return this->simulation_rate; }
+
+    void set_simulation_interpolation(const bool enable) { this->simulation_interpolation = enable; }
+    bool get_simulation_interpolation() const { return this->simulation_interpolation; }
+
     void set_speed_scale(const float speed);
     float get_speed_scale() const;
 
@@ -240,6 +331,41 @@ public:
     void set_mask_viewport_size(const int32_t size) { this->mask_viewport_size = size; }
     int32_t get_mask_viewport_size() const { return this->mask_viewport_size; }
 
+    void set_mask_mode(const MaskMode value);
+    GDCubismUserModel::MaskMode get_mask_mode() const;
+    // the mode the masks are built for, clip children cannot be sampled by GDCubismModel3D
+    GDCubismUserModel::MaskMode get_mask_mode_built() const;
+
+    void set_mask_importance(const float value) { this->mask_importance = value; }
+    float get_mask_importance() const { return this->mask_importance; }
+
+    void set_cull_mode(const CullMode value) { this->cull_mode = value; }
+    GDCubismUserModel::CullMode get_cull_mode() const { return this->cull_mode; }
+
+    void set_cull_margin(const float value) { this->cull_margin = value; }
+    float get_cull_margin() const { return this->cull_margin; }
+
+    void set_cull_throttle_interval(const float value) { this->cull_throttle_interval = value; }
+    float get_cull_throttle_interval() const { return this->cull_throttle_interval; }
+
+    bool is_culled() const { return this->culled; }
+
+    void set_impostor(const bool enable) { this->impostor = enable; }
+    bool get_impostor() const { return this->impostor; }
+
+    void set_impostor_delay(const float value) { this->impostor_delay = value; }
+    float get_impostor_delay() const { return this->impostor_delay; }
+
+    bool is_impostor_active() const;
+
+    void set_lod_levels(const TypedArray<GDCubismLevelOfDetail> &levels);
+    TypedArray<GDCubismLevelOfDetail> get_lod_levels() const { return this->lod_levels; }
+    int32_t get_lod_level() const { return this->lod_level; }
+
+    static void set_mask_texel_budget(const int64_t texels);
+    static int64_t get_mask_texel_budget();
+    static int64_t get_mask_texel_usage();
+
     void _ready() override;
     void _enter_tree() override;
     void _exit_tree() override;
@@ -248,12 +374,19 @@ public:
 
     void _on_append_child_act(GDCubismEffect* node);
     void _on_remove_child_act(GDCubismEffect* node);
+    void _on_attach_texture(GDCubismModelTexture* texture);
+    void _on_detach_texture(GDCubismModelTexture* texture);
+    void _on_attach_model_3d(GDCubismModel3D* node);
+    void _on_detach_model_3d(GDCubismModel3D* node);
 };
 
 VARIANT_ENUM_CAST(GDCubismUserModel::moc3FileFormatVersion);
 VARIANT_ENUM_CAST(GDCubismUserModel::Priority);
 VARIANT_ENUM_CAST(GDCubismUserModel::ParameterMode);
 VARIANT_ENUM_CAST(GDCubismUserModel::MotionProcessCallback);
+VARIANT_ENUM_CAST(GDCubismUserModel::RenderingBackend);
+VARIANT_ENUM_CAST(GDCubismUserModel::MaskMode);
+VARIANT_ENUM_CAST(GDCubismUserModel::CullMode);
 
 
 // ------------------------------------------------------------------ method(s)
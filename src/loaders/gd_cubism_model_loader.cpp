@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: MIT
+#include <loaders/gd_cubism_model_loader.hpp>
+
+#include <gd_cubism_model_data.hpp>
+
+Variant GDCubismModelLoader::_load(const String& p_path, const String& p_original_path, bool p_use_sub_threads, int32_t p_cache_mode) const {
+    Ref<GDCubismModelData> model_data;
+    model_data.instantiate();
+
+    // the files and textures are read here, models only revive their moc from them
+    const Error err = model_data->load(p_path);
+    ERR_FAIL_COND_V_MSG(err != OK, err, "Could not load model: " + p_path);
+
+    return model_data;
+}
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include <private/internal_cubism_load_request.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+HashMap<String, int32_t> InternalCubismLoadRequest::dict_abandoned;
+bool InternalCubismLoadRequest::polling = false;
+
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+// ------------------------------------------------------------------ method(s)
+void InternalCubismLoadRequest::set_polling(const bool enable) {
+    if (polling == enable) return;
+
+    // no model may be left to drive it, the scene tree does
+    SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (tree == nullptr) return;
+
+    const Callable callable = callable_mp_static(&InternalCubismLoadRequest::poll);
+    if (enable) {
+        tree->connect("process_frame", callable);
+    } else {
+        tree->disconnect("process_frame", callable);
+    }
+    polling = enable;
+}
+
+
+Error InternalCubismLoadRequest::request(const String &pathname) {
+    // an abandoned request of the same file is still on its way, it is taken over as it is
+    HashMap<String, int32_t>::Iterator it = dict_abandoned.find(pathname);
+    if (it != dict_abandoned.end()) {
+        it->value -= 1;
+        if (it->value <= 0) dict_abandoned.remove(it);
+        if (dict_abandoned.is_empty()) set_polling(false);
+        return OK;
+    }
+
+    return ResourceLoader::get_singleton()->load_threaded_request(pathname, "GDCubismModelData");
+}
+
+
+void InternalCubismLoadRequest::abandon(const String &pathname) {
+    HashMap<String, int32_t>::Iterator it = dict_abandoned.find(pathname);
+    if (it != dict_abandoned.end()) {
+        it->value += 1;
+    } else {
+        dict_abandoned.insert(pathname, 1);
+    }
+    set_polling(true);
+}
+
+
+void InternalCubismLoadRequest::poll() {
+    ResourceLoader *res_loader = ResourceLoader::get_singleton();
+
+    PackedStringArray ary_done;
+    for (const KeyValue<String, int32_t> &kv : dict_abandoned) {
+        if (res_loader->load_threaded_get_status(kv.key) == ResourceLoader::THREAD_LOAD_IN_PROGRESS) continue;
+
+        // done, so this returns at once, the resource is dropped unless the cache holds it for someone else
+        for (int32_t i = 0; i < kv.value; i++) {
+            res_loader->load_threaded_get(kv.key);
+        }
+        ary_done.append(kv.key);
+    }
+
+    for (int64_t i = 0; i < ary_done.size(); i++) {
+        dict_abandoned.erase(ary_done[i]);
+    }
+    if (dict_abandoned.is_empty()) set_polling(false);
+}
+
+
+void InternalCubismLoadRequest::clear() {
+    ResourceLoader *res_loader = ResourceLoader::get_singleton();
+
+    for (const KeyValue<String, int32_t> &kv : dict_abandoned) {
+        for (int32_t i = 0; i < kv.value; i++) {
+            res_loader->load_threaded_get(kv.key);
+        }
+    }
+
+    dict_abandoned.clear();
+    set_polling(false);
+}
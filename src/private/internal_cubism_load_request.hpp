@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef INTERNAL_CUBISM_LOAD_REQUEST
+#define INTERNAL_CUBISM_LOAD_REQUEST
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+
+// Threaded requests of model files, shared by every model in the process.
+// ResourceLoader keeps a request until it is fetched, and fetching one still running blocks.
+// A model giving up its request abandons it here instead, it is fetched and dropped once done,
+// or taken over again by the next model requesting the same file.
+// ResourceLoader counts the requests of a path, so are the abandoned ones.
+class InternalCubismLoadRequest {
+private:
+    static HashMap<String, int32_t> dict_abandoned;
+    static bool polling;
+
+    static void set_polling(const bool enable);
+
+public:
+    static Error request(const String &pathname);
+    static void abandon(const String &pathname);
+    // fetches the abandoned requests that are done, never waits,
+    // runs every frame from the scene tree while anything is abandoned
+    static void poll();
+    // waits for and fetches what is left
+    static void clear();
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // INTERNAL_CUBISM_LOAD_REQUEST
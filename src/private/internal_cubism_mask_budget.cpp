@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/core/math.hpp>
+
+#include <private/internal_cubism_mask_budget.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// masks never go below this fraction of their resolution, past that they are unreadable anyway
+const static float MASK_BUDGET_SCALE_MIN = 0.125f;
+
+// ------------------------------------------------------------------ static(s)
+int64_t InternalCubismMaskBudget::budget = 0;
+LocalVector<InternalCubismMaskBudget::Entry> InternalCubismMaskBudget::ary_entry;
+
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+// ------------------------------------------------------------------ method(s)
+InternalCubismMaskBudget::Entry &InternalCubismMaskBudget::request_entry(const void *owner) {
+    for (uint32_t i = 0; i < ary_entry.size(); i++) {
+        if (ary_entry[i].owner == owner) return ary_entry[i];
+    }
+
+    Entry entry;
+    entry.owner = owner;
+    entry.demand = 0;
+    entry.allocated = 0;
+    entry.importance = 1.0f;
+    ary_entry.push_back(entry);
+
+    return ary_entry[ary_entry.size() - 1];
+}
+
+
+int64_t InternalCubismMaskBudget::get_usage() {
+    int64_t usage = 0;
+    for (uint32_t i = 0; i < ary_entry.size(); i++) {
+        usage += ary_entry[i].allocated;
+    }
+
+    return usage;
+}
+
+
+float InternalCubismMaskBudget::update(const void *owner, const int64_t demand, const int64_t allocated, const float importance) {
+    Entry &entry = request_entry(owner);
+    entry.demand = demand;
+    entry.allocated = allocated;
+    entry.importance = MAX(importance, 0.0f);
+
+    if (budget <= 0 || demand <= 0) return 1.0f;
+
+    int64_t total = 0;
+    double weighted = 0.0;
+    for (uint32_t i = 0; i < ary_entry.size(); i++) {
+        total += ary_entry[i].demand;
+        weighted += double(ary_entry[i].demand) * ary_entry[i].importance;
+    }
+
+    if (total <= budget) return 1.0f;
+    if (weighted <= 0.0) return MASK_BUDGET_SCALE_MIN;
+
+    // share = budget * demand * importance / weighted, the ratio to the demand is in texels,
+    // the scale applies to both axes
+    const double ratio = double(budget) * entry.importance / weighted;
+    return CLAMP(float(Math::sqrt(ratio)), MASK_BUDGET_SCALE_MIN, 1.0f);
+}
+
+
+void InternalCubismMaskBudget::suspend(const void *owner) {
+    for (uint32_t i = 0; i < ary_entry.size(); i++) {
+        if (ary_entry[i].owner != owner) continue;
+
+        ary_entry[i].demand = 0;
+        return;
+    }
+}
+
+
+void InternalCubismMaskBudget::release(const void *owner) {
+    for (uint32_t i = 0; i < ary_entry.size(); i++) {
+        if (ary_entry[i].owner != owner) continue;
+
+        ary_entry.remove_at_unordered(i);
+        return;
+    }
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef INTERNAL_CUBISM_MASK_BUDGET
+#define INTERNAL_CUBISM_MASK_BUDGET
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+
+// Texel budget for mask render targets, shared by every model in the process.
+// Each model reports the texels its masks want at full resolution and the texels it holds,
+// and gets back the linear scale its masks should be rendered at.
+// Over budget, the budget is split by demand weighted with the model's importance,
+// so models larger on screen keep more resolution.
+class InternalCubismMaskBudget {
+private:
+    struct Entry {
+        const void *owner;
+        int64_t demand;
+        int64_t allocated;
+        float importance;
+    };
+
+    static int64_t budget;
+    static LocalVector<Entry> ary_entry;
+
+    static Entry &request_entry(const void *owner);
+
+public:
+    // 0 disables the budget
+    static void set_budget(const int64_t texels) { budget = texels > 0 ? texels : 0; }
+    static int64_t get_budget() { return budget; }
+
+    // texels held by the mask targets of all models
+    static int64_t get_usage();
+    static bool is_over_budget() { return budget > 0 && get_usage() > budget; }
+
+    static float update(const void *owner, const int64_t demand, const int64_t allocated, const float importance);
+    // the model keeps its targets but stops asking for texels, the next update() asks again
+    static void suspend(const void *owner);
+    static void release(const void *owner);
+    static void clear() { ary_entry.clear(); }
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // INTERNAL_CUBISM_MASK_BUDGET
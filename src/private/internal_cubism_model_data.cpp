@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
+
+#include <CubismModelSettingJson.hpp>
+
+#include <private/internal_cubism_model_data.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace Live2D::Cubism::Framework;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+InternalCubismModelData::InternalCubismModelData()
+    : loaded(false)
+    , owned(false)
+    , setting(nullptr)
+    , moc(nullptr)
+    , moc_version(0) {
+}
+
+
+InternalCubismModelData::~InternalCubismModelData() {
+    if(this->owned == false) return;
+    if(this->moc != nullptr) CubismMoc::Delete(this->moc);
+    if(this->setting != nullptr) CSM_DELETE(this->setting);
+}
+
+
+void InternalCubismModelData::read_file(const String &pathname) {
+    PackedByteArray buffer = FileAccess::get_file_as_bytes(pathname);
+    if(buffer.size() > 0) this->dict_file[pathname] = buffer;
+}
+
+
+bool InternalCubismModelData::load(const String &pathname) {
+    this->model_pathname = pathname;
+    this->owned = true;
+
+    PackedByteArray buffer = FileAccess::get_file_as_bytes(pathname);
+    if(buffer.size() == 0) return false;
+    this->dict_file[pathname] = buffer;
+
+    // parsing only reads the json, ids are looked up when a model asks for them on the main thread
+    this->setting = CSM_NEW CubismModelSettingJson(buffer.ptr(), buffer.size());
+    ICubismModelSetting &model_setting = *this->setting;
+    if(strcmp(model_setting.GetModelFileName(), "") == 0) return false;
+
+    const String base_dir = pathname.get_base_dir();
+
+    {
+        String gd_filename; gd_filename.parse_utf8(model_setting.GetModelFileName());
+        this->moc_pathname = base_dir.path_join(gd_filename);
+
+        buffer = FileAccess::get_file_as_bytes(this->moc_pathname);
+        if(buffer.size() == 0) return false;
+
+        this->moc_version = Live2D::Cubism::Core::csmGetMocVersion(buffer.ptr(), buffer.size());
+        this->dict_file[this->moc_pathname] = buffer;
+
+        // a moc creates any number of models, the bytes are copied into its own aligned block
+        this->moc = CubismMoc::Create(buffer.ptr(), buffer.size());
+        if(this->moc == nullptr) return false;
+    }
+
+    const char *ary_name[] = {
+        model_setting.GetPhysicsFileName(),
+        model_setting.GetPoseFileName(),
+        model_setting.GetUserDataFile()
+    };
+    for(const char *name : ary_name) {
+        if(strcmp(name, "") == 0) continue;
+        String gd_filename; gd_filename.parse_utf8(name);
+        this->read_file(base_dir.path_join(gd_filename));
+    }
+
+    // all of them, whether a model creates them is up to its load_expressions and load_motions
+    for(csmInt32 i = 0; i < model_setting.GetExpressionCount(); i++) {
+        String gd_filename; gd_filename.parse_utf8(model_setting.GetExpressionFileName(i));
+        this->read_file(base_dir.path_join(gd_filename));
+    }
+
+    for(csmInt32 ig = 0; ig < model_setting.GetMotionGroupCount(); ig++) {
+        const csmChar* group = model_setting.GetMotionGroupName(ig);
+        for(csmInt32 im = 0; im < model_setting.GetMotionCount(group); im++) {
+            String gd_filename; gd_filename.parse_utf8(model_setting.GetMotionFileName(group, im));
+            this->read_file(base_dir.path_join(gd_filename));
+        }
+    }
+
+    ResourceLoader *res_loader = ResourceLoader::get_singleton();
+    for(csmInt32 index = 0; index < model_setting.GetTextureCount(); index++) {
+        if(strcmp(model_setting.GetTextureFileName(index), "") == 0) continue;
+
+        String gd_filename; gd_filename.parse_utf8(model_setting.GetTextureFileName(index));
+        String texture_pathname = base_dir.path_join(gd_filename);
+
+        Ref<Texture2D> tex;
+        // allow dynamically loading image textures for models provided from disk or user data
+        if(!res_loader->exists(texture_pathname)) {
+            Ref<Image> img = Image::load_from_file(texture_pathname);
+            tex = ImageTexture::create_from_image(img);
+            tex->take_over_path(texture_pathname);
+        } else {
+            tex = res_loader->load(texture_pathname);
+        }
+
+        this->ary_texture.append(tex);
+    }
+
+    this->loaded = true;
+
+    return true;
+}
+
+
+bool InternalCubismModelData::revive(const InternalCubismModelData &source) {
+    if(source.is_loaded() == false) return false;
+
+    // everything here is only read from now on, sharing it is enough
+    this->dict_file = source.dict_file;
+    this->moc_pathname = source.moc_pathname;
+    this->model_pathname = source.model_pathname;
+    this->moc_version = source.moc_version;
+    this->ary_texture = source.ary_texture;
+    this->setting = source.setting;
+    this->moc = source.moc;
+    this->owned = false;
+
+    this->loaded = true;
+
+    return true;
+}
+
+
+PackedByteArray InternalCubismModelData::get_file(const String &pathname) const {
+    if(this->dict_file.has(pathname) == true) return this->dict_file[pathname];
+    return FileAccess::get_file_as_bytes(pathname);
+}
+
+
+// ------------------------------------------------------------------ method(s)
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef INTERNAL_CUBISM_MODEL_DATA
+#define INTERNAL_CUBISM_MODEL_DATA
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <CubismFramework.hpp>
+#include <ICubismModelSetting.hpp>
+#include <Model/CubismMoc.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+
+// Everything a model3.json refers to, read and decoded up front.
+// load() fills the bytes and textures, parses the setting and revives the moc,
+// which GDCubismModelData shares between every model using them.
+// revive() makes a copy for one model that refers to all of it without owning it,
+// the Cubism objects needing ids or holding state (the model, motions, physics, pose)
+// are created from that later on for each model.
+class InternalCubismModelData {
+public:
+    InternalCubismModelData();
+    ~InternalCubismModelData();
+
+private:
+    // files read for this model by pathname, the ones missing here are read from disk when asked for
+    Dictionary dict_file;
+    String moc_pathname;
+    bool loaded;
+    // setting and moc are deleted with the data that loaded them, copies only refer to them
+    bool owned;
+
+    void read_file(const String &pathname);
+
+public:
+    String model_pathname;
+    // shared by every model created from this data, which has to outlive them
+    Csm::ICubismModelSetting *setting;
+    Csm::CubismMoc *moc;
+    Live2D::Cubism::Core::csmVersion moc_version;
+    // Texture2D by texture index
+    Array ary_texture;
+
+    // touches neither the scene nor the Cubism id registry, safe on a loader thread
+    bool load(const String &pathname);
+    bool revive(const InternalCubismModelData &source);
+    bool is_loaded() const { return this->loaded; }
+    PackedByteArray get_file(const String &pathname) const;
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // INTERNAL_CUBISM_MODEL_DATA
@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/canvas_item.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+
+#include <private/internal_cubism_object_pool.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+LocalVector<MeshInstance2D*> InternalCubismObjectPool::ary_mesh_instance;
+LocalVector<SubViewport*> InternalCubismObjectPool::ary_viewport;
+LocalVector<InternalCubismObjectPool::ServerViewport> InternalCubismObjectPool::ary_server_viewport;
+LocalVector<Ref<ArrayMesh>> InternalCubismObjectPool::ary_array_mesh;
+LocalVector<Ref<ShaderMaterial>> InternalCubismObjectPool::ary_shader_material;
+
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+// ------------------------------------------------------------------ method(s)
+MeshInstance2D *InternalCubismObjectPool::request_mesh_instance() {
+    if (ary_mesh_instance.size() == 0) return memnew(MeshInstance2D);
+
+    MeshInstance2D *node = ary_mesh_instance[ary_mesh_instance.size() - 1];
+    ary_mesh_instance.remove_at(ary_mesh_instance.size() - 1);
+
+    return node;
+}
+
+
+void InternalCubismObjectPool::release_mesh_instance(MeshInstance2D *node) {
+    Node *parent = node->get_parent();
+    if (parent != nullptr) parent->remove_child(node);
+
+    if (ary_mesh_instance.size() >= OBJECT_POOL_SIZE_MAX) {
+        node->queue_free();
+        return;
+    }
+
+    // back to how memnew leaves it, the next model sets only what it uses
+    node->set_mesh(Ref<Mesh>());
+    node->set_texture(Ref<Texture2D>());
+    reset_canvas_item(node);
+
+    ary_mesh_instance.push_back(node);
+}
+
+
+void InternalCubismObjectPool::reset_canvas_item(CanvasItem *item) {
+    item->set_name(item->get_class());
+    item->set_material(Ref<Material>());
+    item->set_use_parent_material(false);
+    item->set_transform(Transform2D());
+    item->set_z_index(0);
+    item->set_z_as_relative(true);
+    item->set_y_sort_enabled(false);
+    item->set_visible(true);
+    item->set_modulate(Color(1, 1, 1, 1));
+    item->set_self_modulate(Color(1, 1, 1, 1));
+    item->set_show_behind_parent(false);
+    item->set_as_top_level(false);
+    item->set_clip_children_mode(CanvasItem::CLIP_CHILDREN_DISABLED);
+    item->set_light_mask(1);
+    item->set_visibility_layer(1);
+    item->set_texture_filter(CanvasItem::TEXTURE_FILTER_PARENT_NODE);
+    item->set_texture_repeat(CanvasItem::TEXTURE_REPEAT_PARENT_NODE);
+    item->set_process_mode(Node::PROCESS_MODE_INHERIT);
+
+    TypedArray<StringName> ary_meta = item->get_meta_list();
+    for (int64_t i = 0; i < ary_meta.size(); i++) {
+        item->remove_meta(ary_meta[i]);
+    }
+    TypedArray<StringName> ary_group = item->get_groups();
+    for (int64_t i = 0; i < ary_group.size(); i++) {
+        // internal groups belong to the engine
+        if (String(ary_group[i]).begins_with("_")) continue;
+        item->remove_from_group(ary_group[i]);
+    }
+
+    // set straight on the canvas item by the renderer, the node does not know about them
+    RenderingServer *rs = RenderingServer::get_singleton();
+    rs->canvas_item_set_custom_rect(item->get_canvas_item(), false);
+    rs->canvas_item_set_clip(item->get_canvas_item(), false);
+}
+
+
+SubViewport *InternalCubismObjectPool::request_viewport() {
+    if (ary_viewport.size() == 0) return memnew(SubViewport);
+
+    SubViewport *viewport = ary_viewport[ary_viewport.size() - 1];
+    ary_viewport.remove_at(ary_viewport.size() - 1);
+
+    return viewport;
+}
+
+
+void InternalCubismObjectPool::release_viewport(SubViewport *viewport) {
+    Node *parent = viewport->get_parent();
+    if (parent != nullptr) parent->remove_child(viewport);
+
+    if (ary_viewport.size() >= OBJECT_POOL_SIZE_MAX) {
+        viewport->queue_free();
+        return;
+    }
+
+    // the render target is given up, only the viewport itself is kept
+    viewport->set_update_mode(SubViewport::UpdateMode::UPDATE_DISABLED);
+    viewport->set_size(Vector2i(1, 1));
+    viewport->set_name(viewport->get_class());
+
+    ary_viewport.push_back(viewport);
+}
+
+
+bool InternalCubismObjectPool::request_server_viewport(RID &viewport, RID &canvas) {
+    if (ary_server_viewport.size() == 0) return false;
+
+    const ServerViewport &pooled = ary_server_viewport[ary_server_viewport.size() - 1];
+    viewport = pooled.viewport;
+    canvas = pooled.canvas;
+    ary_server_viewport.remove_at(ary_server_viewport.size() - 1);
+
+    return true;
+}
+
+
+void InternalCubismObjectPool::release_server_viewport(const RID viewport, const RID canvas) {
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    if (ary_server_viewport.size() >= OBJECT_POOL_SIZE_MAX) {
+        rs->free_rid(canvas);
+        rs->free_rid(viewport);
+        return;
+    }
+
+    rs->viewport_set_update_mode(viewport, RenderingServer::VIEWPORT_UPDATE_DISABLED);
+    rs->viewport_set_size(viewport, 1, 1);
+
+    ServerViewport pooled;
+    pooled.viewport = viewport;
+    pooled.canvas = canvas;
+    ary_server_viewport.push_back(pooled);
+}
+
+
+Ref<ArrayMesh> InternalCubismObjectPool::request_array_mesh() {
+    if (ary_array_mesh.size() == 0) return Ref<ArrayMesh>(memnew(ArrayMesh));
+
+    Ref<ArrayMesh> mesh = ary_array_mesh[ary_array_mesh.size() - 1];
+    ary_array_mesh.remove_at(ary_array_mesh.size() - 1);
+
+    return mesh;
+}
+
+
+void InternalCubismObjectPool::release_array_mesh(const Ref<ArrayMesh> &mesh) {
+    if (ary_array_mesh.size() >= OBJECT_POOL_SIZE_MAX) return;
+
+    mesh->clear_surfaces();
+    ary_array_mesh.push_back(mesh);
+}
+
+
+Ref<ShaderMaterial> InternalCubismObjectPool::request_shader_material() {
+    if (ary_shader_material.size() == 0) return Ref<ShaderMaterial>(memnew(ShaderMaterial));
+
+    Ref<ShaderMaterial> material = ary_shader_material[ary_shader_material.size() - 1];
+    ary_shader_material.remove_at(ary_shader_material.size() - 1);
+
+    return material;
+}
+
+
+void InternalCubismObjectPool::release_shader_material(const Ref<ShaderMaterial> &material) {
+    if (ary_shader_material.size() >= OBJECT_POOL_SIZE_MAX) return;
+
+    // the parameters are cleared by the resource, which knows the uniform names
+    material->set_shader(Ref<Shader>());
+    ary_shader_material.push_back(material);
+}
+
+
+void InternalCubismObjectPool::clear() {
+    for (uint32_t i = 0; i < ary_mesh_instance.size(); i++) {
+        memdelete(ary_mesh_instance[i]);
+    }
+    for (uint32_t i = 0; i < ary_viewport.size(); i++) {
+        memdelete(ary_viewport[i]);
+    }
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    for (uint32_t i = 0; i < ary_server_viewport.size(); i++) {
+        rs->free_rid(ary_server_viewport[i].canvas);
+        rs->free_rid(ary_server_viewport[i].viewport);
+    }
+
+    ary_mesh_instance.clear();
+    ary_viewport.clear();
+    ary_server_viewport.clear();
+    ary_array_mesh.clear();
+    ary_shader_material.clear();
+}
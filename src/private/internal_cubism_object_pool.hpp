@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef INTERNAL_CUBISM_OBJECT_POOL
+#define INTERNAL_CUBISM_OBJECT_POOL
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/mesh_instance2d.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+
+// Objects released by the renderer resources of every model in the process,
+// handed out again before anything new is created.
+// Pooled objects are reset so they hold on to nothing: nodes are outside of the tree,
+// meshes have no surface, materials no shader and viewports are at the smallest size.
+class InternalCubismObjectPool {
+private:
+    struct ServerViewport {
+        RID viewport;
+        RID canvas;
+    };
+
+    static LocalVector<MeshInstance2D*> ary_mesh_instance;
+    static LocalVector<SubViewport*> ary_viewport;
+    static LocalVector<ServerViewport> ary_server_viewport;
+    static LocalVector<Ref<ArrayMesh>> ary_array_mesh;
+    static LocalVector<Ref<ShaderMaterial>> ary_shader_material;
+
+    static void reset_canvas_item(CanvasItem *item);
+
+public:
+    static MeshInstance2D *request_mesh_instance();
+    static void release_mesh_instance(MeshInstance2D *node);
+
+    // configured by the caller, see InternalCubismRendererResource::request_viewport
+    static SubViewport *request_viewport();
+    static void release_viewport(SubViewport *viewport);
+
+    // false when nothing is pooled, the canvas is attached to the viewport
+    static bool request_server_viewport(RID &viewport, RID &canvas);
+    static void release_server_viewport(const RID viewport, const RID canvas);
+
+    // the caller holds the last reference of what it releases
+    static Ref<ArrayMesh> request_array_mesh();
+    static void release_array_mesh(const Ref<ArrayMesh> &mesh);
+    static Ref<ShaderMaterial> request_shader_material();
+    static void release_shader_material(const Ref<ShaderMaterial> &material);
+
+    // everything pooled is freed, called when the module is uninitialized
+    static void clear();
+};
+
+
+// ------------------------------------------------------------------ method(s)
+
+
+#endif // INTERNAL_CUBISM_OBJECT_POOL
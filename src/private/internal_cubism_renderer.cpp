@@ -8,8 +8,6 @@
 
 #ifdef GD_CUBISM_USE_RENDERER_2D
     #include <private/internal_cubism_renderer_2d.hpp>
-#else
-    #include <private/internal_cubism_renderer_3d.hpp>
 #endif // GD_CUBISM_USE_RENDERER_2D
 
 #include <private/internal_cubism_user_model.hpp>
@@ -26,11 +24,9 @@ using namespace Live2D::Cubism::Framework::Rendering;
 // ----------------------------------------------------------- class:forward(s)
 // ------------------------------------------------------------------- class(s)
 CubismRenderer* CubismRenderer::Create() {
-    #ifdef GD_CUBISM_USE_RENDERER_2D
+    // the 2D renderer is the only one driven by the framework, InternalCubismRenderer3D
+    // builds its mesh from the resource the 2D one keeps up to date
     return CSM_NEW InternalCubismRenderer2D();
-    #else
-    return CSM_NEW InternalCubismRenderer3D();
-    #endif // GD_CUBISM_USE_RENDERER_2D
 }
 
 void CubismRenderer::StaticRelease() {
@@ -15,6 +15,8 @@
 #include <private/internal_cubism_renderer_2d.hpp>
 #include <private/internal_cubism_renderer_resource.hpp>
 #include <private/internal_cubism_user_model.hpp>
+#include <private/internal_cubism_mask_budget.hpp>
+#include <private/internal_cubism_vertex_kernel.hpp>
 
 // ------------------------------------------------------------------ define(s)
 // --------------------------------------------------------------- namespace(s)
@@ -25,14 +27,32 @@ using namespace godot;
 
 // -------------------------------------------------------------------- enum(s)
 // ------------------------------------------------------------------- const(s)
+// smallest mask target, and how far below its size class a mask has to shrink before the target is swapped
+const static int32_t MASK_TARGET_SIZE_MIN = 32;
+const static float MASK_TARGET_SHRINK_RATIO = 0.375f;
+
 // ------------------------------------------------------------------ static(s)
 PackedInt32Array make_Indices(const csmUint16 *ptr, const int32_t &size);
 PackedVector2Array make_UVs(const Live2D::Cubism::Core::csmVector2 *ptr, const int32_t &size);
 PackedVector2Array make_Vertices(const Live2D::Cubism::Core::csmVector2 *ptr, const int32_t &size, const Csm::csmFloat32 &ppunit);
 const Vector4 make_vector4(const Live2D::Cubism::Core::csmVector4 &src_vec4);
+void write_Colors(uint8_t *dst, const int32_t stride, const int32_t size, const Vector4 &color);
+void write_UVs(uint8_t *dst, const int32_t stride, const PackedVector2Array &uv);
+void set_mask_item_visible(InternalCubismMaskItem &item, const bool visible);
+void set_mask_item_transform(InternalCubismMaskItem &item, const Transform2D &transform, const Rect2 &bounds);
+bool set_mask_target_size(InternalCubismMaskTarget &target, const Vector2i &size);
+void request_mask_target_update(InternalCubismMaskTarget &target);
+Vector2i mask_size_class(const Vector2i &size, const int32_t max_size);
 
 // ----------------------------------------------------------- class:forward(s)
 // ------------------------------------------------------------------- class(s)
+// a context waiting for a target to be resized or created, see update_clip_context
+struct InternalCubismMaskRequest {
+    Csm::csmUint32 context;
+    Vector2i size;
+    Rect2 bounds;
+};
+
 InternalCubismRenderer2D::InternalCubismRenderer2D()
 {
 }
@@ -41,13 +61,59 @@ InternalCubismRenderer2D::~InternalCubismRenderer2D()
 {
 }
 
-void InternalCubismRenderer2D::update_material(const Csm::CubismModel *model, const Csm::csmInt32 index, const Ref<ShaderMaterial> mat) const
+bool InternalCubismRenderer2D::write_color(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res) const
+{
+    InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    if (drawable.mesh.is_null()) return false;
+
+    const CubismTextureColor color = this->GetModelColorWithOpacity(model->GetDrawableOpacity(index));
+    const Vector4 color_base(color.R, color.G, color.B, color.A);
+    const Vector4 color_screen = make_vector4(model->GetDrawableScreenColor(index));
+    const Vector4 color_multiply = make_vector4(model->GetDrawableMultiplyColor(index));
+
+    // the opacity flag also fires for drawables whose colors did not change
+    if (
+        drawable.color_valid &&
+        drawable.color_base == color_base &&
+        drawable.color_screen == color_screen &&
+        drawable.color_multiply == color_multiply
+    ) return false;
+
+    drawable.color_base = color_base;
+    drawable.color_screen = color_screen;
+    drawable.color_multiply = color_multiply;
+    drawable.color_valid = true;
+
+    const int32_t vertex_count = model->GetDrawableVertexCount(index);
+    uint8_t *dst = drawable.attribute.ptrw();
+    write_Colors(dst + drawable.offset_color, drawable.attribute_stride, vertex_count, color_base);
+    write_Colors(dst + drawable.offset_custom0, drawable.attribute_stride, vertex_count, color_screen);
+    write_Colors(dst + drawable.offset_custom1, drawable.attribute_stride, vertex_count, color_multiply);
+    drawable.color_revision++;
+
+    // shaders written before the colors moved into the attributes read them as uniforms
+    if (drawable.color_uniform && drawable.material != nullptr) {
+        drawable.material->set_shader_parameter(res.uniform.color_base, color_base);
+        drawable.material->set_shader_parameter(res.uniform.color_screen, color_screen);
+        drawable.material->set_shader_parameter(res.uniform.color_multiply, color_multiply);
+    }
+
+    return true;
+}
+
+void InternalCubismRenderer2D::update_color(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res) const
 {
-    const CubismTextureColor color_base = this->GetModelColorWithOpacity(model->GetDrawableOpacity(index));
+    if (this->write_color(model, index, res) == false) return;
 
-    mat->set_shader_parameter("color_base", Vector4(color_base.R, color_base.G, color_base.B, color_base.A));
-    mat->set_shader_parameter("color_screen", make_vector4(model->GetDrawableScreenColor(index)));
-    mat->set_shader_parameter("color_multiply", make_vector4(model->GetDrawableMultiplyColor(index)));
+    const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    RenderingServer::get_singleton()->mesh_surface_update_attribute_region(
+        drawable.mesh->get_rid(), 0, 0, drawable.attribute);
 }
 
 void InternalCubismRenderer2D::make_ArrayMesh_prepare(
@@ -63,16 +129,16 @@ void InternalCubismRenderer2D::make_ArrayMesh_prepare(
     res.CALCULATED_PPUNIT_C = ppunit;
 }
 
-void InternalCubismRenderer2D::update_mesh(
+Ref<ArrayMesh> InternalCubismRenderer2D::build_mesh(
     const Csm::CubismModel *model,
     const Csm::csmInt32 index,
-    const bool maskmode,
-    const InternalCubismRendererResource &res,
-    const MeshInstance2D *node
+    InternalCubismRendererResource &res
 ) const
 {
-    Ref<ArrayMesh> ary_mesh = node->get_mesh();
-    ary_mesh->clear_surfaces();
+    InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    if (drawable.mesh.is_valid()) return drawable.mesh;
+
+    Ref<ArrayMesh> ary_mesh = res.request_array_mesh();
 
     Array ary;
 
@@ -83,21 +149,327 @@ void InternalCubismRenderer2D::update_mesh(
         model->GetDrawableVertexCount(index),
         res.CALCULATED_PPUNIT_C);
 
-    ary[Mesh::ARRAY_TEX_UV] = make_UVs(
+    // uv and index data never change for a loaded moc, they are converted once here
+    // and live in their own attribute and index buffers next to the vertex stream
+    const PackedVector2Array ary_uv = make_UVs(
         model->GetDrawableVertexUvs(index),
         model->GetDrawableVertexCount(index));
+    ary[Mesh::ARRAY_TEX_UV] = ary_uv;
 
     ary[Mesh::ARRAY_INDEX] = make_Indices(
         model->GetDrawableVertexIndices(index),
         model->GetDrawableVertexIndexCount(index));
 
-    ary_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, ary);
+    // color_base, color_screen and color_multiply, written for real by update_color
+    PackedColorArray ary_color;
+    ary_color.resize(model->GetDrawableVertexCount(index));
+    ary_color.fill(Color(1.0, 1.0, 1.0, 1.0));
+    PackedByteArray ary_custom;
+    ary_custom.resize(model->GetDrawableVertexCount(index) * 4);
+    ary_custom.fill(0);
+    ary[Mesh::ARRAY_COLOR] = ary_color;
+    ary[Mesh::ARRAY_CUSTOM0] = ary_custom;
+    ary[Mesh::ARRAY_CUSTOM1] = ary_custom;
+
+    // the surface is created once and kept for the lifetime of the model,
+    // afterwards only its vertex region is rewritten by update_mesh
+    ary_mesh->add_surface_from_arrays(
+        Mesh::PRIMITIVE_TRIANGLES, ary,
+        TypedArray<Array>(), Dictionary(),
+        Mesh::ARRAY_FLAG_USE_DYNAMIC_UPDATE |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM1_SHIFT));
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+    const int64_t format = static_cast<int64_t>(ary_mesh->surface_get_format(0));
+    const int32_t vertex_count = model->GetDrawableVertexCount(index);
+
+    drawable.mesh = ary_mesh;
+    drawable.stride = rs->mesh_surface_get_format_vertex_stride(format, vertex_count);
+
+    // the attribute stream also holds the uv, only the colors are patched afterwards.
+    // it is laid out here as the surface was just uploaded, reading it back would stall on the gpu
+    drawable.attribute_stride = rs->mesh_surface_get_format_attribute_stride(format, vertex_count);
+    drawable.offset_color = rs->mesh_surface_get_format_offset(format, vertex_count, Mesh::ARRAY_COLOR);
+    drawable.offset_custom0 = rs->mesh_surface_get_format_offset(format, vertex_count, Mesh::ARRAY_CUSTOM0);
+    drawable.offset_custom1 = rs->mesh_surface_get_format_offset(format, vertex_count, Mesh::ARRAY_CUSTOM1);
+    drawable.attribute.resize(drawable.attribute_stride * vertex_count);
+    drawable.attribute.fill(0);
+    write_UVs(
+        drawable.attribute.ptrw() + rs->mesh_surface_get_format_offset(format, vertex_count, Mesh::ARRAY_TEX_UV),
+        drawable.attribute_stride, ary_uv);
+    write_Colors(
+        drawable.attribute.ptrw() + drawable.offset_color,
+        drawable.attribute_stride, vertex_count, Vector4(1.0, 1.0, 1.0, 1.0));
+    drawable.color_valid = false;
+    drawable.vertex.resize(drawable.stride * model->GetDrawableVertexCount(index));
+    drawable.bounds = write_Vertices(
+        model->GetDrawableVertexPositions(index),
+        model->GetDrawableVertexCount(index),
+        res.CALCULATED_PPUNIT_C,
+        drawable.stride,
+        drawable.vertex.ptrw());
+    drawable.lod_area = MAX(drawable.lod_area, float(drawable.bounds.get_area()));
+    drawable.vertex_revision++;
+    drawable.dirty = false;
+
+    return ary_mesh;
+}
 
-    AABB bounds = ary_mesh->get_aabb();
-    RenderingServer::get_singleton()->canvas_item_set_custom_rect(
-        node->get_canvas_item(), true,
-        Rect2(bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y)
-    );
+bool InternalCubismRenderer2D::write_mesh(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res
+) const
+{
+    InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    if (drawable.mesh.is_null()) return false;
+    // unchanged since the last write, this also keeps a drawable referenced
+    // as mask by several others from being uploaded more than once per update
+    if (drawable.dirty == false) return false;
+
+    const Csm::csmInt32 vertex_count = model->GetDrawableVertexCount(index);
+    const Live2D::Cubism::Core::csmVector2 *positions = model->GetDrawableVertexPositions(index);
+    if (res.use_interpolation && drawable.moving) {
+        res.interpolation_scratch.resize(vertex_count * 2);
+        Live2D::Cubism::Core::csmVector2 *blended = reinterpret_cast<Live2D::Cubism::Core::csmVector2 *>(res.interpolation_scratch.ptrw());
+        lerp_Positions(
+            reinterpret_cast<const Live2D::Cubism::Core::csmVector2 *>(drawable.position_from.ptr()),
+            reinterpret_cast<const Live2D::Cubism::Core::csmVector2 *>(drawable.position_to.ptr()),
+            vertex_count,
+            res.interpolation_alpha,
+            blended);
+        positions = blended;
+    }
+
+    drawable.bounds = write_Vertices(
+        positions,
+        vertex_count,
+        res.CALCULATED_PPUNIT_C,
+        drawable.stride,
+        drawable.vertex.ptrw());
+    drawable.lod_area = MAX(drawable.lod_area, float(drawable.bounds.get_area()));
+    drawable.vertex_revision++;
+    drawable.dirty = false;
+
+    return true;
+}
+
+void InternalCubismRenderer2D::update_interpolation(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res) const
+{
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.mesh.is_null()) continue;
+
+        const Csm::csmInt32 size = model->GetDrawableVertexCount(index) * 2;
+        const float *positions = reinterpret_cast<const float *>(model->GetDrawableVertexPositions(index));
+
+        // both ends start at the current pose, nothing is blended until the next step
+        if (res.interpolation_seeded == false) {
+            drawable.position_from.resize(size);
+            drawable.position_to.resize(size);
+            memcpy(drawable.position_from.ptrw(), positions, size * sizeof(float));
+            memcpy(drawable.position_to.ptrw(), positions, size * sizeof(float));
+            drawable.moving = false;
+            continue;
+        }
+
+        if (res.interpolation_step) {
+            // one more write lands a drawable that just stopped exactly on its last pose
+            if (drawable.moving) drawable.dirty = true;
+
+            drawable.moving = model->GetDrawableDynamicFlagVertexPositionsDidChange(index);
+            memcpy(drawable.position_from.ptrw(), drawable.position_to.ptr(), size * sizeof(float));
+            if (drawable.moving) {
+                memcpy(drawable.position_to.ptrw(), positions, size * sizeof(float));
+            }
+        } else if (drawable.moving) {
+            drawable.dirty = true;
+        }
+    }
+
+    res.interpolation_seeded = true;
+    res.interpolation_step = false;
+}
+
+void InternalCubismRenderer2D::update_mesh(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res
+) const
+{
+    if (this->write_mesh(model, index, res) == false) return;
+
+    const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    RenderingServer::get_singleton()->mesh_surface_update_vertex_region(
+        drawable.mesh->get_rid(), 0, 0, drawable.vertex);
+}
+
+bool InternalCubismRenderer2D::capture_impostor(InternalCubismRendererResource &res, const float scale) const
+{
+    const CubismModel *model = this->GetModel();
+    RenderingServer *rs = RenderingServer::get_singleton();
+    InternalCubismImpostor &impostor = res.impostor;
+
+    if (res.has_model_bounds == false) return false;
+
+    if (impostor.viewport.is_valid() == false) {
+        impostor.viewport = rs->viewport_create();
+        rs->viewport_set_disable_3d(impostor.viewport, SUBVIEWPORT_DISABLE_3D_FLAG);
+        rs->viewport_set_clear_mode(impostor.viewport, RenderingServer::VIEWPORT_CLEAR_ALWAYS);
+        rs->viewport_set_update_mode(impostor.viewport, RenderingServer::VIEWPORT_UPDATE_DISABLED);
+        rs->viewport_set_transparent_background(impostor.viewport, true);
+        rs->viewport_set_active(impostor.viewport, true);
+
+        impostor.canvas = rs->canvas_create();
+        rs->viewport_attach_canvas(impostor.viewport, impostor.canvas);
+
+        // the drawables blend premultiplied into a transparent target, the texture is drawn the same way
+        impostor.material.instantiate();
+        impostor.material->set_blend_mode(CanvasItemMaterial::BLEND_MODE_PREMULT_ALPHA);
+
+        impostor.sprite = rs->canvas_item_create();
+        rs->canvas_item_set_parent(impostor.sprite, res._owner_viewport->get_canvas_item());
+        rs->canvas_item_set_material(impostor.sprite, impostor.material->get_rid());
+    }
+
+    // one pixel of room keeps the filtered edge of the texture inside the model bounds
+    const Rect2 bounds = res.model_bounds.grow(1.0);
+    const real_t longest = MAX(bounds.size.x, bounds.size.y);
+    const float texel_scale = longest * scale > IMPOSTOR_SIZE_MAX ? float(IMPOSTOR_SIZE_MAX / longest) : scale;
+    const Vector2i size(
+        MAX(1, int32_t(Math::ceil(bounds.size.x * texel_scale))),
+        MAX(1, int32_t(Math::ceil(bounds.size.y * texel_scale))));
+    rs->viewport_set_size(impostor.viewport, size.x, size.y);
+
+    // a capture while already shown only follows the scale, the copies still hold the frozen pose
+    if (impostor.active == false) {
+        impostor.root = rs->canvas_item_create();
+        rs->canvas_item_set_parent(impostor.root, impostor.canvas);
+        this->build_mirror(res, impostor.root, impostor.items);
+    }
+    rs->canvas_item_set_transform(impostor.root, Transform2D(
+        Vector2(texel_scale, 0.0),
+        Vector2(0.0, texel_scale),
+        -bounds.position * texel_scale));
+
+    rs->viewport_set_update_mode(impostor.viewport, RenderingServer::VIEWPORT_UPDATE_ONCE);
+
+    rs->canvas_item_clear(impostor.sprite);
+    rs->canvas_item_add_texture_rect(impostor.sprite, bounds, rs->viewport_get_texture(impostor.viewport));
+    rs->canvas_item_set_visible(impostor.sprite, true);
+    impostor.scale = scale;
+
+    if (impostor.active) return true;
+    impostor.active = true;
+
+    // everything the model draws itself is hidden, the update after the release shows it again
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.node != nullptr) drawable.node->set_visible(false);
+        else if (drawable.canvas_item.is_valid()) rs->canvas_item_set_visible(drawable.canvas_item, false);
+    }
+    for (Csm::csmUint32 b = 0; b < res.ary_batch.GetSize(); b++)
+    {
+        InternalCubismBatch &batch = res.ary_batch[b];
+        batch.visible = false;
+        if (batch.node != nullptr) batch.node->set_visible(false);
+        else rs->canvas_item_set_visible(batch.canvas_item, false);
+    }
+    for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[c];
+        if (context.clip_children == false) continue;
+        context.active = false;
+        for (Csm::csmUint32 g = 0; g < context.segment_count; g++) {
+            context.segments[g].active = false;
+            rs->canvas_item_set_visible(context.segments[g].clip_item, false);
+        }
+    }
+
+    return true;
+}
+
+void InternalCubismRenderer2D::build_mirror(
+    InternalCubismRendererResource &res,
+    const RID root,
+    Csm::csmVector<RID> &items) const
+{
+    const CubismModel *model = this->GetModel();
+    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    // clip parents are copied with their masks, the clipped copies go below them as in the model
+    Csm::csmVector<Csm::csmVector<RID>> clip_copy;
+    clip_copy.Resize(res.ary_clip_context.GetSize());
+    for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++)
+    {
+        const InternalCubismClipContext &context = res.ary_clip_context[c];
+        if (context.clip_children == false || context.active == false) continue;
+
+        clip_copy[c].Resize(context.segment_count, RID());
+        for (Csm::csmUint32 g = 0; g < context.segment_count; g++)
+        {
+            const InternalCubismClipSegment &segment = context.segments[g];
+            if (segment.active == false) continue;
+
+            const RID item = rs->canvas_item_create();
+            rs->canvas_item_set_parent(item, root);
+            rs->canvas_item_set_canvas_group_mode(item, RenderingServer::CANVAS_GROUP_MODE_CLIP_ONLY);
+            rs->canvas_item_set_material(item, context.clip_material->get_rid());
+            rs->canvas_item_set_z_index(item, segment.z_base);
+            this->add_clip_masks(model, res, context, item);
+            clip_copy[c][g] = item;
+            items.PushBack(item);
+        }
+    }
+
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.mesh.is_null() || drawable.material == nullptr) continue;
+        // merged drawables are drawn by the copy of their batch below
+        if (drawable.batch >= 0) continue;
+        if (drawable.lod_hidden) continue;
+        if (model->GetDrawableDynamicFlagIsVisible(index) == false) continue;
+        if (model->GetDrawableOpacity(index) <= 0.0f) continue;
+
+        RID parent = root;
+        Csm::csmInt32 z = renderOrder[index];
+        if (
+            drawable.clip_context >= 0 &&
+            drawable.clip_segment >= 0 &&
+            drawable.clip_segment < Csm::csmInt32(clip_copy[drawable.clip_context].GetSize()) &&
+            clip_copy[drawable.clip_context][drawable.clip_segment].is_valid()
+        ) {
+            parent = clip_copy[drawable.clip_context][drawable.clip_segment];
+            z -= res.ary_clip_context[drawable.clip_context].segments[drawable.clip_segment].z_base;
+        }
+
+        const RID item = rs->canvas_item_create();
+        rs->canvas_item_set_parent(item, parent);
+        rs->canvas_item_add_mesh(item, drawable.mesh->get_rid());
+        rs->canvas_item_set_material(item, drawable.material->get_rid());
+        rs->canvas_item_set_z_index(item, z);
+        items.PushBack(item);
+    }
+
+    for (Csm::csmUint32 b = 0; b < res.ary_batch.GetSize(); b++)
+    {
+        const InternalCubismBatch &batch = res.ary_batch[b];
+        if (batch.visible == false) continue;
+
+        const RID item = rs->canvas_item_create();
+        rs->canvas_item_set_parent(item, root);
+        rs->canvas_item_add_mesh(item, batch.mesh->get_rid());
+        rs->canvas_item_set_material(item, res.ary_drawable_mesh[batch.drawables[0]].material->get_rid());
+        rs->canvas_item_set_z_index(item, renderOrder[batch.drawables[0]]);
+        items.PushBack(item);
+    }
 }
 
 Vector2 InternalCubismRenderer2D::get_size(const Csm::CubismModel *model) const
@@ -137,90 +509,895 @@ void InternalCubismRenderer2D::update(InternalCubismRendererResource &res, int32
 {
     const CubismModel *model = this->GetModel();
     const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
-    const Csm::csmInt32 *maskCount = model->GetDrawableMaskCounts();
+    RenderingServer *rs = RenderingServer::get_singleton();
 
     this->make_ArrayMesh_prepare(
         model,
         res);
 
+    bool force_update = res.force_update;
+    res.force_update = false;
+    res.drawables_changed = force_update;
+    res.structure_changed = force_update;
+
+    if (res.use_interpolation) {
+        this->update_interpolation(model, res);
+    } else {
+        res.interpolation_seeded = false;
+    }
+
+    // regrouping the batches hands drawables back to their own canvas items, which are then
+    // out of date in every respect, so this update refreshes everything
+    if (res.use_batching && this->update_batch(model, res, force_update)) {
+        force_update = true;
+    }
+
+    // dynamic flags accumulate across updates until they are reset below, a pending
+    // vertex change is carried by the drawable until its mesh is actually uploaded
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        if (force_update || model->GetDrawableDynamicFlagVertexPositionsDidChange(index)) {
+            res.ary_drawable_mesh[index].dirty = true;
+        }
+    }
+
     for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
     {
         if (model->GetDrawableVertexCount(index) == 0)
             continue;
         if (model->GetDrawableVertexIndexCount(index) == 0)
             continue;
-        
-        CubismIdHandle handle = model->GetDrawableId(index);
-        String node_name(handle->GetString().GetRawString());
-        MeshInstance2D *node = Object::cast_to<MeshInstance2D>(res.dict_mesh[node_name]);
-        if (node == nullptr) {
+
+        // node is null with the server backend, the canvas item is then changed directly
+        MeshInstance2D *node = res.ary_drawable_mesh[index].node;
+        const RID canvas_item = res.ary_drawable_mesh[index].canvas_item;
+        if (canvas_item.is_valid() == false) {
+            continue;
+        }
+
+        // drawables too small on screen for the current level of detail are treated as hidden.
+        // a drawable below the cutoff is not written, so its area is taken from the moved vertices
+        // directly, otherwise it would never grow back past the cutoff
+        InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (
+            drawable.lod_area < res.lod_area_min &&
+            (force_update || model->GetDrawableDynamicFlagVertexPositionsDidChange(index))
+        ) {
+            const Rect2 bounds = bounds_Vertices(
+                model->GetDrawableVertexPositions(index),
+                model->GetDrawableVertexCount(index),
+                res.CALCULATED_PPUNIT_C);
+            drawable.lod_area = MAX(drawable.lod_area, float(bounds.get_area()));
+        }
+        const bool lod_hidden = drawable.lod_area < res.lod_area_min;
+        const bool lod_changed = drawable.lod_hidden != lod_hidden;
+        drawable.lod_hidden = lod_hidden;
+
+        const bool visible = !lod_hidden && model->GetDrawableDynamicFlagIsVisible(index) && model->GetDrawableOpacity(index) > 0.0f;
+        const bool visibility_changed = force_update || lod_changed
+            || model->GetDrawableDynamicFlagVisibilityDidChange(index)
+            || model->GetDrawableDynamicFlagOpacityDidChange(index);
+        const bool order_changed = force_update || model->GetDrawableDynamicFlagRenderOrderDidChange(index);
+        const bool color_changed = force_update
+            || model->GetDrawableDynamicFlagOpacityDidChange(index)
+            || model->GetDrawableDynamicFlagBlendColorDidChange(index);
+
+        if (visibility_changed || order_changed || color_changed || res.ary_drawable_mesh[index].dirty) {
+            res.drawables_changed = true;
+        }
+        if (visibility_changed || order_changed) {
+            res.structure_changed = true;
+        }
+
+        if (res.ary_drawable_mesh[index].batch >= 0) {
+            this->update_batched(model, index, res, visible, visibility_changed, color_changed);
+            continue;
+        }
+
+        if (visibility_changed) {
+            if (node == nullptr) rs->canvas_item_set_visible(canvas_item, visible);
+            else node->set_visible(visible);
+        }
+
+        if (color_changed) {
+            this->update_color(model, index, res);
+        }
+
+        // the order flag is consumed this update, hidden drawables still have to take it
+        if (order_changed) {
+            if (node == nullptr) rs->canvas_item_set_z_index(canvas_item, renderOrder[index]);
+            else node->set_z_index(renderOrder[index]);
+        }
+
+        if (visible && res.ary_drawable_mesh[index].dirty) {
+            this->update_mesh(model, index, res);
+            // bounds are gathered while the vertex buffer is written, the ArrayMesh aabb
+            // is only valid for the pose the surface was created with
+            rs->canvas_item_set_custom_rect(canvas_item, true, res.ary_drawable_mesh[index].bounds);
+        }
+    }
+
+    if (res.use_batching) {
+        this->flush_batch(model, res);
+    }
+
+    this->update_clip_context(model, res, mask_viewport_size, force_update);
+
+    this->merge_model_bounds(model, res);
+
+    Live2D::Cubism::Core::csmResetDrawableDynamicFlags(model->GetModel());
+}
+
+void InternalCubismRenderer2D::merge_model_bounds(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res) const
+{
+    // hidden drawables are not written, so only the drawn ones have current bounds
+    res.has_model_bounds = false;
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        if (model->GetDrawableVertexCount(index) == 0) continue;
+        if (model->GetDrawableDynamicFlagIsVisible(index) == false) continue;
+        if (model->GetDrawableOpacity(index) <= 0.0f) continue;
+        if (res.ary_drawable_mesh[index].lod_hidden) continue;
+
+        const Rect2 &drawable_bounds = res.ary_drawable_mesh[index].bounds;
+        res.model_bounds = res.has_model_bounds ? res.model_bounds.merge(drawable_bounds) : drawable_bounds;
+        res.has_model_bounds = true;
+    }
+}
+
+void InternalCubismRenderer2D::update_bounds(InternalCubismRendererResource &res) const
+{
+    const CubismModel *model = this->GetModel();
+
+    // nothing is written while the model is not drawn, the pending vertices only give their bounds
+    // so the model can be found on screen again. the dynamic flags are left for the next update
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.mesh.is_null() || drawable.lod_hidden) continue;
+        if (model->GetDrawableDynamicFlagVertexPositionsDidChange(index) == false) continue;
+
+        drawable.bounds = bounds_Vertices(
+            model->GetDrawableVertexPositions(index),
+            model->GetDrawableVertexCount(index),
+            res.CALCULATED_PPUNIT_C);
+    }
+
+    this->merge_model_bounds(model, res);
+}
+
+bool InternalCubismRenderer2D::update_batch(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    const bool force_update) const
+{
+    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
+    const Csm::csmInt32 count = model->GetDrawableCount();
+
+    bool order_changed = force_update;
+    for (Csm::csmInt32 index = 0; index < count && !order_changed; index++) {
+        order_changed = model->GetDrawableDynamicFlagRenderOrderDidChange(index);
+    }
+    if (!order_changed) return false;
+
+    Csm::csmVector<Csm::csmInt32> sorted;
+    sorted.Resize(count, -1);
+    for (Csm::csmInt32 index = 0; index < count; index++) {
+        sorted[renderOrder[index]] = index;
+    }
+
+    // runs of batchable drawables next to each other in render order with the same material,
+    // the material already stands for the shader (blend mode) and the texture
+    Csm::csmVector<Csm::csmInt32> runs;
+    Csm::csmVector<Csm::csmInt32> run_size;
+    Csm::csmInt32 prev = -1;
+    for (Csm::csmInt32 k = 0; k < count; k++)
+    {
+        const Csm::csmInt32 index = sorted[k];
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.batchable == false) {
+            prev = -1;
+            continue;
+        }
+
+        if (prev >= 0 && res.ary_drawable_mesh[prev].material == drawable.material) {
+            run_size[run_size.GetSize() - 1]++;
+        } else {
+            run_size.PushBack(1);
+        }
+        runs.PushBack(index);
+        prev = index;
+    }
+
+    // only runs of two or more are worth a mesh of their own
+    Csm::csmVector<Csm::csmVector<Csm::csmInt32>> grouped;
+    for (Csm::csmUint32 r = 0, first = 0; r < run_size.GetSize(); first += run_size[r], r++)
+    {
+        if (run_size[r] < 2) continue;
+
+        grouped.PushBack(Csm::csmVector<Csm::csmInt32>());
+        Csm::csmVector<Csm::csmInt32> &run = grouped[grouped.GetSize() - 1];
+        for (Csm::csmInt32 i = 0; i < run_size[r]; i++) {
+            run.PushBack(runs[first + i]);
+        }
+    }
+
+    bool same = grouped.GetSize() == res.ary_batch.GetSize();
+    for (Csm::csmUint32 b = 0; b < grouped.GetSize() && same; b++)
+    {
+        const Csm::csmVector<Csm::csmInt32> &drawables = res.ary_batch[b].drawables;
+        same = drawables.GetSize() == grouped[b].GetSize();
+        for (Csm::csmUint32 i = 0; i < drawables.GetSize() && same; i++) {
+            same = drawables[i] == grouped[b][i];
+        }
+    }
+
+    // the same runs in a different place of the render order only move the batches
+    if (same) {
+        RenderingServer *rs = RenderingServer::get_singleton();
+        for (Csm::csmUint32 b = 0; b < res.ary_batch.GetSize(); b++)
+        {
+            InternalCubismBatch &batch = res.ary_batch[b];
+            const Csm::csmInt32 z = renderOrder[batch.drawables[0]];
+            if (batch.node != nullptr) batch.node->set_z_index(z);
+            else rs->canvas_item_set_z_index(batch.canvas_item, z);
+        }
+        return false;
+    }
+
+    this->release_batch(res);
+    for (Csm::csmUint32 b = 0; b < grouped.GetSize(); b++) {
+        this->build_batch(model, res, grouped[b]);
+    }
+
+    return true;
+}
+
+void InternalCubismRenderer2D::build_batch(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    const Csm::csmVector<Csm::csmInt32> &run) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+    const Csm::csmInt32 b = res.ary_batch.GetSize();
+
+    res.ary_batch.PushBack(InternalCubismBatch());
+    InternalCubismBatch &batch = res.ary_batch[b];
+
+    // uv and indices of every member are concatenated once, positions and colors are copied in later
+    int32_t vertex_count = 0;
+    PackedVector2Array ary_uv;
+    PackedInt32Array ary_index;
+    for (Csm::csmUint32 i = 0; i < run.GetSize(); i++)
+    {
+        const Csm::csmInt32 index = run[i];
+        InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        drawable.batch = b;
+        drawable.batch_vertex = vertex_count;
+        batch.drawables.PushBack(index);
+
+        ary_uv.append_array(make_UVs(
+            model->GetDrawableVertexUvs(index),
+            model->GetDrawableVertexCount(index)));
+
+        PackedInt32Array indices = make_Indices(
+            model->GetDrawableVertexIndices(index),
+            model->GetDrawableVertexIndexCount(index));
+        for (int64_t j = 0; j < indices.size(); j++) {
+            indices[j] += vertex_count;
+        }
+        ary_index.append_array(indices);
+
+        vertex_count += model->GetDrawableVertexCount(index);
+    }
+
+    PackedVector2Array ary_vertex;
+    ary_vertex.resize(vertex_count);
+    ary_vertex.fill(Vector2(0.0, 0.0));
+    PackedColorArray ary_color;
+    ary_color.resize(vertex_count);
+    ary_color.fill(Color(1.0, 1.0, 1.0, 1.0));
+    PackedByteArray ary_custom;
+    ary_custom.resize(vertex_count * 4);
+    ary_custom.fill(0);
+
+    Array ary;
+    ary.resize(Mesh::ARRAY_MAX);
+    ary[Mesh::ARRAY_VERTEX] = ary_vertex;
+    ary[Mesh::ARRAY_TEX_UV] = ary_uv;
+    ary[Mesh::ARRAY_INDEX] = ary_index;
+    ary[Mesh::ARRAY_COLOR] = ary_color;
+    ary[Mesh::ARRAY_CUSTOM0] = ary_custom;
+    ary[Mesh::ARRAY_CUSTOM1] = ary_custom;
+
+    batch.mesh = res.request_array_mesh();
+    batch.mesh->add_surface_from_arrays(
+        Mesh::PRIMITIVE_TRIANGLES, ary,
+        TypedArray<Array>(), Dictionary(),
+        Mesh::ARRAY_FLAG_USE_DYNAMIC_UPDATE |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM1_SHIFT));
+
+    // same format as the member meshes, so their vertex and attribute ranges are copied as they are
+    const int64_t format = static_cast<int64_t>(batch.mesh->surface_get_format(0));
+    batch.stride = rs->mesh_surface_get_format_vertex_stride(format, vertex_count);
+    batch.attribute_stride = rs->mesh_surface_get_format_attribute_stride(format, vertex_count);
+    batch.vertex.resize(batch.stride * vertex_count);
+    batch.vertex.fill(0);
+    // every vertex belongs to one member, whose attributes are copied over the whole stream
+    batch.attribute.resize(batch.attribute_stride * vertex_count);
+    batch.attribute.fill(0);
+
+    for (Csm::csmUint32 i = 0; i < run.GetSize(); i++)
+    {
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[run[i]];
+        memcpy(
+            batch.attribute.ptrw() + drawable.batch_vertex * batch.attribute_stride,
+            drawable.attribute.ptr(),
+            drawable.attribute.size());
+    }
+    batch.vertex_dirty = true;
+    batch.attribute_dirty = true;
+
+    const InternalCubismDrawableMesh &first = res.ary_drawable_mesh[run[0]];
+    const Csm::csmInt32 z = model->GetDrawableRenderOrders()[run[0]];
+
+    if (res.use_rendering_server) {
+        batch.canvas_item = rs->canvas_item_create();
+        rs->canvas_item_set_parent(batch.canvas_item, res._owner_viewport->get_canvas_item());
+        rs->canvas_item_add_mesh(batch.canvas_item, batch.mesh->get_rid());
+        rs->canvas_item_set_material(batch.canvas_item, first.material->get_rid());
+        rs->canvas_item_set_z_index(batch.canvas_item, z);
+        rs->canvas_item_set_visible(batch.canvas_item, false);
+    } else {
+        batch.node = res.request_mesh_instance(batch.mesh);
+        batch.node->set_material(first.material);
+        batch.node->set_name(String("__batch_") + String::num_int64(b));
+        batch.node->set_z_index(z);
+        batch.node->set_visible(false);
+        res._owner_viewport->add_child(batch.node);
+        res.managed_nodes.append(batch.node);
+        batch.canvas_item = batch.node->get_canvas_item();
+    }
+
+    // the members stay built, they are only hidden while the batch draws them
+    for (Csm::csmUint32 i = 0; i < run.GetSize(); i++)
+    {
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[run[i]];
+        if (drawable.node != nullptr) drawable.node->set_visible(false);
+        else rs->canvas_item_set_visible(drawable.canvas_item, false);
+    }
+}
+
+void InternalCubismRenderer2D::release_batch(InternalCubismRendererResource &res) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    for (Csm::csmUint32 b = 0; b < res.ary_batch.GetSize(); b++)
+    {
+        InternalCubismBatch &batch = res.ary_batch[b];
+        if (batch.node != nullptr) {
+            res.release_mesh_instance(batch.node);
+        } else if (batch.canvas_item.is_valid()) {
+            rs->free_rid(batch.canvas_item);
+        }
+        res.release_array_mesh(batch.mesh);
+
+        // their own meshes were not uploaded while batched
+        for (Csm::csmUint32 i = 0; i < batch.drawables.GetSize(); i++) {
+            InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[batch.drawables[i]];
+            drawable.batch = -1;
+            drawable.dirty = true;
+            drawable.color_valid = false;
+        }
+    }
+
+    res.ary_batch.Clear();
+}
+
+void InternalCubismRenderer2D::update_batched(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res,
+    const bool visible,
+    const bool visibility_changed,
+    const bool color_changed) const
+{
+    InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+    InternalCubismBatch &batch = res.ary_batch[drawable.batch];
+    const int32_t vertex_count = model->GetDrawableVertexCount(index);
+
+    if (color_changed && this->write_color(model, index, res)) {
+        memcpy(
+            batch.attribute.ptrw() + drawable.batch_vertex * batch.attribute_stride,
+            drawable.attribute.ptr(),
+            vertex_count * batch.attribute_stride);
+        batch.attribute_dirty = true;
+    }
+
+    // a hidden member is collapsed onto the origin, its triangles have no area and draw nothing
+    if (visible && (drawable.dirty || visibility_changed)) {
+        this->write_mesh(model, index, res);
+        memcpy(
+            batch.vertex.ptrw() + drawable.batch_vertex * batch.stride,
+            drawable.vertex.ptr(),
+            vertex_count * batch.stride);
+        batch.vertex_dirty = true;
+    } else if (!visible && visibility_changed) {
+        memset(
+            batch.vertex.ptrw() + drawable.batch_vertex * batch.stride,
+            0,
+            vertex_count * batch.stride);
+        batch.vertex_dirty = true;
+    }
+}
+
+void InternalCubismRenderer2D::flush_batch(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    for (Csm::csmUint32 b = 0; b < res.ary_batch.GetSize(); b++)
+    {
+        InternalCubismBatch &batch = res.ary_batch[b];
+
+        if (batch.attribute_dirty) {
+            rs->mesh_surface_update_attribute_region(batch.mesh->get_rid(), 0, 0, batch.attribute);
+            batch.attribute_dirty = false;
+        }
+
+        if (batch.vertex_dirty == false) continue;
+        batch.vertex_dirty = false;
+
+        bool visible = false;
+        Rect2 bounds;
+        for (Csm::csmUint32 i = 0; i < batch.drawables.GetSize(); i++)
+        {
+            const Csm::csmInt32 index = batch.drawables[i];
+            if (model->GetDrawableDynamicFlagIsVisible(index) == false) continue;
+            if (model->GetDrawableOpacity(index) <= 0.0f) continue;
+            if (res.ary_drawable_mesh[index].lod_hidden) continue;
+
+            const Rect2 &drawable_bounds = res.ary_drawable_mesh[index].bounds;
+            bounds = visible ? bounds.merge(drawable_bounds) : drawable_bounds;
+            visible = true;
+        }
+
+        if (batch.visible != visible) {
+            batch.visible = visible;
+            if (batch.node != nullptr) batch.node->set_visible(visible);
+            else rs->canvas_item_set_visible(batch.canvas_item, visible);
+        }
+        if (!visible) continue;
+
+        rs->mesh_surface_update_vertex_region(batch.mesh->get_rid(), 0, 0, batch.vertex);
+        rs->canvas_item_set_custom_rect(batch.canvas_item, true, bounds);
+    }
+}
+
+void InternalCubismRenderer2D::update_clip_context(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    const int32_t mask_viewport_size,
+    const bool force_update) const
+{
+    const bool use_atlas = res.mask_mode == GDCubismUserModel::MASK_MODE_ATLAS;
+
+    // a drawable moving into or out of a clip group only flags its own order as changed
+    bool order_changed = force_update;
+    if (res.mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN) {
+        for (Csm::csmInt32 index = 0; index < model->GetDrawableCount() && !order_changed; index++) {
+            order_changed = model->GetDrawableDynamicFlagRenderOrderDidChange(index);
+        }
+    }
+
+    // drawables always sit at the origin of the model, so the model transform is shared by all of them
+    const Transform2D canvas_transform = res._owner_viewport->get_global_transform_with_canvas();
+    const Rect2 viewport_rect = res._owner_viewport->get_viewport_rect();
+
+    // the budget answer lags one update behind, the demand is only known after walking the contexts
+    const bool over_budget = InternalCubismMaskBudget::is_over_budget();
+    int64_t demand = 0;
+    Csm::csmVector<InternalCubismMaskRequest> ary_request;
+
+    for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[c];
+
+        if (context.clip_children) {
+            this->update_clip_item(model, res, context, order_changed, force_update);
             continue;
         }
-        const bool visible = model->GetDrawableDynamicFlagIsVisible(index) && model->GetDrawableOpacity(index) > 0.0f;
-        node->set_visible(visible);
-        Ref<ShaderMaterial> mat = node->get_material();
-        
-        if (visible) {
-            this->update_mesh(model, index, false, res, node);
-            this->update_material(model, index, mat);
-            node->set_z_index(renderOrder[index]);
-        }
-        
-        // adjust real bounds to prevent the mesh being culled
-        AABB bounds = node->get_mesh()->get_aabb();
-        Rect2 canvas_bounds = Rect2(bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y);
-        RenderingServer::get_singleton()->canvas_item_set_custom_rect(
-            node->get_canvas_item(), true,
-            canvas_bounds
-        );
-
-        if (!node->has_meta("viewport")) continue;
-
-        SubViewport *viewport = Object::cast_to<SubViewport>(node->get_meta("viewport"));
-        
-        // detect if the canvas item is going to be culled
-        // only cull viewports when not looking at the model in the editor
-        Rect2 bounds_in_viewport = node->get_global_transform_with_canvas().xform(canvas_bounds);
-        const bool is_culled = 
+
+        // the mask has to cover every visible drawable clipped by it
+        bool has_bounds = false;
+        Rect2 bounds;
+        for (Csm::csmUint32 i = 0; i < context.clipped.GetSize(); i++)
+        {
+            const Csm::csmInt32 index = context.clipped[i];
+            if (model->GetDrawableDynamicFlagIsVisible(index) == false) continue;
+            if (model->GetDrawableOpacity(index) <= 0.0f) continue;
+            if (res.ary_drawable_mesh[index].lod_hidden) continue;
+
+            const Rect2 &drawable_bounds = res.ary_drawable_mesh[index].bounds;
+            bounds = has_bounds ? bounds.merge(drawable_bounds) : drawable_bounds;
+            has_bounds = true;
+        }
+
+        // detect if the masked drawables are going to be culled
+        // only cull masks when not looking at the model in the editor, or when copies of it
+        // are drawn somewhere the viewport says nothing about
+        const Rect2 bounds_in_viewport = canvas_transform.xform(bounds);
+        const bool is_culled =
             !Engine::get_singleton()->is_editor_hint() &&
+            !res.use_mirrors &&
             !(
-                node->get_viewport_rect().intersects(bounds_in_viewport) 
-                || node->get_viewport_rect().encloses(bounds_in_viewport)
+                viewport_rect.intersects(bounds_in_viewport)
+                || viewport_rect.encloses(bounds_in_viewport)
             );
+        const bool active = has_bounds && !is_culled;
+
+        // the target is only rendered again when something feeding this context changed,
+        // its visibility, the mask geometry, or the mapping onto the target
+        bool changed = force_update || context.active != active;
+
+        if (changed) {
+            for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++) {
+                set_mask_item_visible(context.items[m], active);
+            }
+        }
+        context.active = active;
 
-        if (!visible || is_culled){
-            viewport->set_size(Vector2i(2,2));
+        if (!active) {
+            // hidden or culled, the target goes back to the pool instead of being shrunk in place
+            if (!use_atlas) this->release_mask_target(res, context);
             continue;
         }
 
-        // optimize mask viewport size by scaling it relative to the viewport transform
-        // maximum resolution should be equal to raw size from mesh dimensions, or the upper bound defined on the model
-        Vector2 mask_size = Math::min(bounds_in_viewport.size, canvas_bounds.size);
-        Vector2 vp_scale = Vector2(mask_size) / Vector2(canvas_bounds.size);
-        double scalar = 1.0;
-        if (mask_viewport_size > 0) {
-            if (mask_size.x > mask_viewport_size || mask_size.y > mask_viewport_size) {
-                scalar = mask_viewport_size / Math::max(mask_size.x, mask_size.y);
-                Vector2 ratio = Vector2(
-                    Math::min(1.0f, mask_size.x / mask_size.y),
-                    Math::min(1.0f, mask_size.y / mask_size.x)
-                );
-                mask_size = Vector2(mask_viewport_size, mask_viewport_size) * ratio;
+        Vector2 tile_offset;
+        if (use_atlas) {
+            // the tile is fixed, the bounds are fitted into it with a 1px border
+            // so linear filtering does not pick up the neighbouring tile
+            const Vector2 tile_size = context.tile.size - Vector2(2.0, 2.0);
+            context.scale = MIN(
+                tile_size.x / MAX(bounds.size.x, (real_t)1.0),
+                tile_size.y / MAX(bounds.size.y, (real_t)1.0));
+            tile_offset = context.tile.position + Vector2(1.0, 1.0);
+        } else {
+            // optimize mask viewport size by scaling it relative to the viewport transform
+            // maximum resolution should be equal to raw size from mesh dimensions, or the upper bound defined on the model
+            float scale = MIN(1.0f, float(bounds_in_viewport.size.x / MAX(bounds.size.x, (real_t)1.0)));
+            const float longest = MAX(bounds.size.x, bounds.size.y) * scale;
+            if (mask_viewport_size > 0 && longest > mask_viewport_size) {
+                scale *= mask_viewport_size / longest;
             }
+            scale *= res.lod_mask_scale;
+            // the demand is what the mask would take at full resolution, the budget scales below that
+            const Vector2i full_size = mask_size_class(Vector2i(
+                MAX(1, int32_t(Math::ceil(bounds.size.x * scale))),
+                MAX(1, int32_t(Math::ceil(bounds.size.y * scale)))), mask_viewport_size);
+            demand += int64_t(full_size.x) * full_size.y;
+
+            scale *= res.mask_budget_scale;
+            context.scale = scale;
+            tile_offset = Vector2(0.0, 0.0);
+
+            // the target only covers the mask at its top left, so it can be larger than required.
+            // it is kept while the required size stays inside its size class, and swapped for a pooled
+            // target once it has to grow, or the mask shrank well below the next smaller class
+            const Vector2i required(
+                MAX(1, int32_t(Math::ceil(bounds.size.x * scale))),
+                MAX(1, int32_t(Math::ceil(bounds.size.y * scale))));
+            // over budget every target drops to its size class right away instead of waiting for the hysteresis
+            const Vector2i current = context.target >= 0 ? res.ary_mask_target[context.target].size : Vector2i();
+            const Vector2i size_class = mask_size_class(required, mask_viewport_size);
+
+            if (
+                context.target < 0 ||
+                required.x > current.x || required.y > current.y ||
+                required.x < current.x * MASK_TARGET_SHRINK_RATIO ||
+                required.y < current.y * MASK_TARGET_SHRINK_RATIO ||
+                (over_budget && size_class != current)
+            ) {
+                // targets released by contexts further down are only idle after the walk,
+                // a target is resized only once none of them turned out to have the size
+                if (this->acquire_mask_target(res, context, size_class, false) == false) {
+                    InternalCubismMaskRequest request;
+                    request.context = c;
+                    request.size = size_class;
+                    request.bounds = bounds;
+                    ary_request.PushBack(request);
+                    continue;
+                }
+                changed = true;
+            }
+        }
+
+        this->update_mask_layout(model, res, context, bounds, tile_offset, changed);
+    }
+
+    for (Csm::csmUint32 r = 0; r < ary_request.GetSize(); r++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[ary_request[r].context];
+        this->acquire_mask_target(res, context, ary_request[r].size, true);
+        this->update_mask_layout(model, res, context, ary_request[r].bounds, Vector2(0.0, 0.0), true);
+    }
+
+    // idle targets only exist to skip an allocation, they are the first thing given up over budget
+    if (over_budget) {
+        for (Csm::csmUint32 i = 0; i < res.ary_mask_target_idle.GetSize(); i++) {
+            set_mask_target_size(res.ary_mask_target[res.ary_mask_target_idle[i]], Vector2i(MASK_TARGET_SIZE_MIN, MASK_TARGET_SIZE_MIN));
+        }
+    }
+
+    int64_t allocated = 0;
+    for (Csm::csmUint32 t = 0; t < res.ary_mask_target.GetSize(); t++)
+    {
+        InternalCubismMaskTarget &target = res.ary_mask_target[t];
+        allocated += int64_t(target.size.x) * target.size.y;
+
+        if (target.redraw == false) continue;
+
+        target.redraw = false;
+        request_mask_target_update(target);
+    }
+
+    // atlas targets are laid out at build time and do not scale, they only count against the budget
+    if (use_atlas) demand = allocated;
+
+    res.mask_budget_scale = InternalCubismMaskBudget::update(
+        &res, demand, allocated, res._owner_viewport->mask_importance);
+}
+
+void InternalCubismRenderer2D::update_mask_layout(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context,
+    const Rect2 &bounds,
+    const Vector2 &tile_offset,
+    bool changed) const
+{
+    // model space -> target pixels, the same mapping the masked shaders use for MASK_UV
+    const Transform2D transform(
+        Vector2(context.scale, 0.0),
+        Vector2(0.0, context.scale),
+        tile_offset - bounds.position * context.scale);
+
+    const bool layout_changed = changed || context.transform != transform || context.bounds != bounds;
+    context.transform = transform;
+    context.bounds = bounds;
+
+    for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++)
+    {
+        InternalCubismMaskItem &item = context.items[m];
+
+        // a vertex change may have been uploaded by the drawable loop already, or still be pending
+        // from updates where this context was inactive
+        changed = changed
+            || model->GetDrawableDynamicFlagVertexPositionsDidChange(item.drawable)
+            || res.ary_drawable_mesh[item.drawable].dirty;
+
+        // the mask mesh is shared with its drawable, the upload may already have happened this update
+        this->update_mesh(model, item.drawable, res);
+        if (layout_changed) {
+            set_mask_item_transform(item, transform, bounds);
+        }
+    }
+
+    if (layout_changed) {
+        for (Csm::csmUint32 i = 0; i < context.clipped_materials.GetSize(); i++)
+        {
+            const Ref<ShaderMaterial> &mat = context.clipped_materials[i];
+            mat->set_shader_parameter(res.uniform.mask_scale, context.scale);
+            mat->set_shader_parameter(res.uniform.mesh_offset, bounds.position);
+            mat->set_shader_parameter(res.uniform.mask_tile_offset, tile_offset);
+        }
+    }
+
+    if (changed || layout_changed) {
+        res.ary_mask_target[context.target].redraw = true;
+    }
+}
+
+void InternalCubismRenderer2D::update_clip_item(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context,
+    const bool order_changed,
+    const bool force_update) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    if (order_changed) {
+        this->update_clip_segments(model, res, context);
+    }
+
+    // no target to keep up to date, godot culls the groups itself
+    Csm::csmVector<bool> ary_active;
+    ary_active.Resize(context.segment_count, false);
+    for (Csm::csmUint32 i = 0; i < context.clipped.GetSize(); i++)
+    {
+        const Csm::csmInt32 index = context.clipped[i];
+        if (model->GetDrawableDynamicFlagIsVisible(index) == false) continue;
+        if (model->GetDrawableOpacity(index) <= 0.0f) continue;
+        if (res.ary_drawable_mesh[index].lod_hidden) continue;
+        ary_active[res.ary_drawable_mesh[index].clip_segment] = true;
+    }
+
+    bool active = false;
+    for (Csm::csmUint32 g = 0; g < context.segment_count; g++)
+    {
+        InternalCubismClipSegment &segment = context.segments[g];
+        if (order_changed || segment.active != ary_active[g]) {
+            rs->canvas_item_set_visible(segment.clip_item, ary_active[g]);
+        }
+        segment.active = ary_active[g];
+        active = active || segment.active;
+    }
+    context.active = active;
+
+    if (!active) return;
+
+    // masks are often hidden drawables themselves, their meshes are only uploaded here
+    bool changed = force_update || order_changed;
+    Rect2 bounds;
+    for (Csm::csmUint32 m = 0; m < context.masks.GetSize(); m++)
+    {
+        const Csm::csmInt32 j = context.masks[m];
+        changed = changed || res.ary_drawable_mesh[j].dirty;
+        this->update_mesh(model, j, res);
+        bounds = m == 0 ? res.ary_drawable_mesh[j].bounds : bounds.merge(res.ary_drawable_mesh[j].bounds);
+    }
+
+    if (changed) {
+        context.bounds = bounds;
+        for (Csm::csmUint32 g = 0; g < context.segment_count; g++) {
+            rs->canvas_item_set_custom_rect(context.segments[g].clip_item, true, bounds);
+        }
+    }
+}
+
+void InternalCubismRenderer2D::update_clip_segments(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
+
+    Csm::csmVector<Csm::csmInt32> sorted;
+    for (Csm::csmUint32 i = 0; i < context.clipped.GetSize(); i++)
+    {
+        const Csm::csmInt32 index = context.clipped[i];
+        Csm::csmUint32 pos = sorted.GetSize();
+        sorted.PushBack(index);
+        for (; pos > 0 && renderOrder[sorted[pos - 1]] > renderOrder[index]; pos--) {
+            sorted[pos] = sorted[pos - 1];
+        }
+        sorted[pos] = index;
+    }
+
+    // render orders are unique, so any gap between two clipped drawables holds another drawable.
+    // a group is drawn as a whole at the order of its first drawable, so it has to end there
+    Csm::csmUint32 count = 0;
+    for (Csm::csmUint32 k = 0; k < sorted.GetSize(); k++)
+    {
+        const Csm::csmInt32 index = sorted[k];
+        if (k == 0 || renderOrder[index] != renderOrder[sorted[k - 1]] + 1) {
+            if (count == context.segments.GetSize()) {
+                InternalCubismClipSegment segment;
+                segment.clip_item = rs->canvas_item_create();
+                rs->canvas_item_set_parent(segment.clip_item, context.clip_parent);
+                rs->canvas_item_set_canvas_group_mode(segment.clip_item, RenderingServer::CANVAS_GROUP_MODE_CLIP_ONLY);
+                rs->canvas_item_set_material(segment.clip_item, context.clip_material->get_rid());
+                this->add_clip_masks(model, res, context, segment.clip_item);
+                context.segments.PushBack(segment);
+            }
+
+            InternalCubismClipSegment &segment = context.segments[count];
+            segment.z_base = renderOrder[index];
+            rs->canvas_item_set_z_index(segment.clip_item, segment.z_base);
+            count++;
         }
 
-        Vector2 viewport_offset = Vector2(bounds.position.x, bounds.position.y);
-        Transform2D transform = Transform2D(0, -viewport_offset);
-        transform.scale(Size2(scalar, scalar) * vp_scale);
-        viewport->set_size(mask_size);
-        viewport->set_canvas_transform(transform);
+        // the clipped drawables keep their relative order inside of the group
+        InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        const InternalCubismClipSegment &segment = context.segments[count - 1];
+        if (drawable.clip_segment != Csm::csmInt32(count - 1)) {
+            drawable.clip_segment = count - 1;
+            rs->canvas_item_set_parent(res.ary_canvas_item[index].canvas_item, segment.clip_item);
+        }
+        rs->canvas_item_set_z_index(res.ary_canvas_item[index].canvas_item, renderOrder[index] - segment.z_base);
+    }
+
+    // groups left over from an earlier order are kept for when it comes back
+    for (Csm::csmUint32 g = count; g < context.segment_count; g++) {
+        context.segments[g].active = false;
+        rs->canvas_item_set_visible(context.segments[g].clip_item, false);
+    }
+    context.segment_count = count;
+}
+
+void InternalCubismRenderer2D::release_mask_target(
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context) const
+{
+    if (context.target < 0) return;
+
+    res.ary_mask_target_idle.PushBack(context.target);
+    context.target = -1;
+}
+
+bool InternalCubismRenderer2D::acquire_mask_target(
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context,
+    const Vector2i &size,
+    const bool allow_resize) const
+{
+    this->release_mask_target(res, context);
+
+    // prefer an idle target of the same size class, then any idle target resized,
+    // a new target is only created when the pool is empty
+    Csm::csmInt32 found = -1;
+    for (Csm::csmUint32 i = 0; i < res.ary_mask_target_idle.GetSize() && found < 0; i++) {
+        if (res.ary_mask_target[res.ary_mask_target_idle[i]].size == size) found = i;
+    }
+    if (found < 0 && !allow_resize) return false;
+    if (found < 0 && res.ary_mask_target_idle.GetSize() > 0) {
+        found = res.ary_mask_target_idle.GetSize() - 1;
+    }
+
+    Csm::csmInt32 t;
+    if (found >= 0) {
+        t = res.ary_mask_target_idle[found];
+        res.ary_mask_target_idle[found] = res.ary_mask_target_idle[res.ary_mask_target_idle.GetSize() - 1];
+        res.ary_mask_target_idle.Resize(res.ary_mask_target_idle.GetSize() - 1);
+    } else {
+        t = res.request_mask_target(res._owner_viewport);
+    }
+
+    InternalCubismMaskTarget &target = res.ary_mask_target[t];
+    set_mask_target_size(target, size);
+    context.target = t;
+
+    // the mask items follow their context, items of other contexts left in the target stay hidden
+    for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++)
+    {
+        InternalCubismMaskItem &item = context.items[m];
+        if (item.node != nullptr) {
+            if (item.node->get_parent() != target.viewport) item.node->reparent(target.viewport, false);
+        } else {
+            RenderingServer::get_singleton()->canvas_item_set_parent(item.canvas_item, target.canvas);
+        }
+    }
+
+    for (Csm::csmUint32 i = 0; i < context.clipped_materials.GetSize(); i++) {
+        context.clipped_materials[i]->set_shader_parameter(res.uniform.tex_mask, target.texture);
+    }
+
+    return true;
+}
+
+void InternalCubismRenderer2D::group_clip_context(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res) const
+{
+    const bool use_clip_children = res.mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN;
 
-        mat->set_shader_parameter("tex_mask", viewport->get_texture());
-        mat->set_shader_parameter("mask_scale", scalar * vp_scale.x);
-        mat->set_shader_parameter("mesh_offset", viewport_offset);
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
+    {
+        if (model->GetDrawableMaskCounts()[index] == 0)
+            continue;
+        if (model->GetDrawableVertexCount(index) == 0)
+            continue;
+        if (model->GetDrawableVertexIndexCount(index) == 0)
+            continue;
 
-        const Array masks = res.dict_mask[node_name];
-        
+        // kept sorted, so identical mask sets compare equal regardless of their order in the moc
+        Csm::csmVector<Csm::csmInt32> masks;
         for (Csm::csmInt32 m_index = 0; m_index < model->GetDrawableMaskCounts()[index]; m_index++)
         {
             Csm::csmInt32 j = model->GetDrawableMasks()[index][m_index];
@@ -229,120 +1406,418 @@ void InternalCubismRenderer2D::update(InternalCubismRendererResource &res, int32
                 continue;
             if (model->GetDrawableVertexIndexCount(j) == 0)
                 continue;
-    
-            MeshInstance2D *node = Object::cast_to<MeshInstance2D>(masks[m_index]);
-            node->set_visible(visible);
 
-            if (!visible) {
+            Csm::csmUint32 pos = masks.GetSize();
+            masks.PushBack(j);
+            for (; pos > 0 && masks[pos - 1] > j; pos--) {
+                masks[pos] = masks[pos - 1];
+            }
+            masks[pos] = j;
+        }
+
+        // drawables clipped by exactly the same masks (hair strands, eye layers, ...) share one context,
+        // its masks are rendered once and every clipped drawable reads the same tile.
+        // with clip_children the context also decides how the drawable is drawn, inverted ones are kept apart
+        const bool inverted = use_clip_children && model->GetDrawableInvertedMask(index);
+
+        Csm::csmInt32 found = -1;
+        for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize() && found < 0; c++)
+        {
+            const Csm::csmVector<Csm::csmInt32> &other = res.ary_clip_context[c].masks;
+            if (res.ary_clip_context[c].inverted != inverted) continue;
+            if (other.GetSize() != masks.GetSize()) continue;
+
+            bool same = true;
+            for (Csm::csmUint32 m = 0; m < masks.GetSize() && same; m++) {
+                same = other[m] == masks[m];
+            }
+            if (same) found = c;
+        }
+
+        if (found < 0) {
+            InternalCubismClipContext context;
+            context.inverted = inverted;
+            for (Csm::csmUint32 m = 0; m < masks.GetSize(); m++) {
+                context.masks.PushBack(masks[m]);
+            }
+            res.ary_clip_context.PushBack(context);
+            found = res.ary_clip_context.GetSize() - 1;
+        }
+
+        res.ary_clip_context[found].clipped.PushBack(index);
+        res.ary_drawable_mesh[index].clip_context = found;
+    }
+}
+
+void InternalCubismRenderer2D::build_clip_context(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    Node *target_node) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+    const bool use_atlas = res.mask_mode == GDCubismUserModel::MASK_MODE_ATLAS;
+    const bool use_clip_children = res.mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN;
+
+    // clipped drawables of one context share their materials per shader and texture,
+    // each material is only listed once
+    for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[c];
+        for (Csm::csmUint32 i = 0; i < context.clipped.GetSize(); i++)
+        {
+            const Csm::csmInt32 index = context.clipped[i];
+
+            const Ref<ShaderMaterial> mat(res.ary_drawable_mesh[index].material);
+
+            bool listed = false;
+            for (Csm::csmUint32 m = 0; m < context.clipped_materials.GetSize() && !listed; m++) {
+                listed = context.clipped_materials[m] == mat;
+            }
+            if (!listed) context.clipped_materials.PushBack(mat);
+        }
+    }
+
+    const Csm::csmInt32 context_count = res.ary_clip_context.GetSize();
+
+    if (use_atlas)
+    {
+        // contexts are spread over the rgb channels first, then each channel is split into a grid
+        // of up to MASK_ATLAS_GRID x MASK_ATLAS_GRID tiles, a new atlas is started once one is full
+        const Csm::csmInt32 per_atlas = MASK_ATLAS_CHANNELS * MASK_ATLAS_GRID * MASK_ATLAS_GRID;
+        const int32_t mask_viewport_size = res._owner_viewport->get_mask_viewport_size();
+        const int32_t atlas_size = mask_viewport_size > 0 ? mask_viewport_size : MASK_ATLAS_SIZE_DEFAULT;
+
+        for (Csm::csmInt32 first = 0; first < context_count; first += per_atlas)
+        {
+            const Csm::csmInt32 count = MIN(per_atlas, context_count - first);
+            const Csm::csmInt32 target = res.request_mask_target(target_node);
+            set_mask_target_size(res.ary_mask_target[target], Vector2i(atlas_size, atlas_size));
+
+            for (Csm::csmInt32 k = 0; k < count; k++)
+            {
+                InternalCubismClipContext &context = res.ary_clip_context[first + k];
+                const Csm::csmInt32 channel = k % MASK_ATLAS_CHANNELS;
+                const Csm::csmInt32 slot = k / MASK_ATLAS_CHANNELS;
+                const Csm::csmInt32 in_channel = count / MASK_ATLAS_CHANNELS + (channel < count % MASK_ATLAS_CHANNELS ? 1 : 0);
+                const Csm::csmInt32 grid = Csm::csmInt32(Math::ceil(Math::sqrt(double(in_channel))));
+                const real_t tile_size = real_t(atlas_size) / grid;
+
+                context.target = target;
+                context.channel = Vector4(
+                    channel == 0 ? 1.0 : 0.0,
+                    channel == 1 ? 1.0 : 0.0,
+                    channel == 2 ? 1.0 : 0.0,
+                    0.0);
+                context.tile = Rect2(
+                    (slot % grid) * tile_size,
+                    (slot / grid) * tile_size,
+                    tile_size, tile_size);
+            }
+        }
+    }
+    else
+    {
+        // every context starts on the smallest size class, the first update moves it to the right one
+        for (Csm::csmInt32 c = 0; c < context_count; c++)
+        {
+            InternalCubismClipContext &context = res.ary_clip_context[c];
+            if (use_clip_children && context.inverted == false) {
+                this->build_clip_item(model, res, context, Object::cast_to<CanvasItem>(target_node)->get_canvas_item());
                 continue;
             }
+            if (use_clip_children) {
+                WARN_PRINT_ONCE("GDCubismUserModel: MASK_MODE_CLIP_CHILDREN cannot draw inverted masks, they are rendered into mask viewports.");
+            }
+            context.target = res.request_mask_target(target_node);
+            context.channel = Vector4(0.0, 0.0, 0.0, 1.0);
+            set_mask_target_size(res.ary_mask_target[context.target], Vector2i(MASK_TARGET_SIZE_MIN, MASK_TARGET_SIZE_MIN));
+        }
+    }
+
+    for (Csm::csmInt32 c = 0; c < context_count; c++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[c];
+        if (context.target < 0) continue;
+        const InternalCubismMaskTarget &target = res.ary_mask_target[context.target];
+
+        for (Csm::csmUint32 m = 0; m < context.masks.GetSize(); m++)
+        {
+            const Csm::csmInt32 j = context.masks[m];
+
+            InternalCubismMaskItem item;
+            item.drawable = j;
+            item.material = res.request_mask_material();
+            item.material->set_shader_parameter(res.uniform.channel, context.channel);
+            item.material->set_shader_parameter(res.uniform.tex_main, res.ary_texture[model->GetDrawableTextureIndex(j)]);
+
+            if (target.viewport != nullptr) {
+                CubismIdHandle handle = model->GetDrawableId(j);
+
+                item.node = res.request_mesh_instance(this->build_mesh(model, j, res));
+                item.node->set_name(String(handle->GetString().GetRawString()));
+                item.node->set_material(item.material);
+                target.viewport->add_child(item.node);
+                res.managed_nodes.append(item.node);
+                item.canvas_item = item.node->get_canvas_item();
+            } else {
+                item.canvas_item = rs->canvas_item_create();
+                rs->canvas_item_set_parent(item.canvas_item, target.canvas);
+                rs->canvas_item_add_mesh(item.canvas_item, this->build_mesh(model, j, res)->get_rid());
+                rs->canvas_item_set_material(item.canvas_item, item.material->get_rid());
+            }
+            // clipped to its custom rect, which always is the context bounds,
+            // so masks larger than the clipped drawables do not spill into other tiles
+            rs->canvas_item_set_clip(item.canvas_item, true);
 
-            this->update_mesh(model, j, true, res, node);
-            node->set_z_index(renderOrder[index]);
+            context.items.PushBack(item);
         }
+
+        // the target texture stays the same across resizes, it is bound once here
+        for (Csm::csmUint32 i = 0; i < context.clipped_materials.GetSize(); i++)
+        {
+            const Ref<ShaderMaterial> &mat = context.clipped_materials[i];
+            mat->set_shader_parameter(res.uniform.tex_mask, target.texture);
+            mat->set_shader_parameter(res.uniform.channel, context.channel);
+            mat->set_shader_parameter(res.uniform.canvas_size, Vector2(res.vct_canvas_size));
+            mat->set_shader_parameter(res.uniform.mesh_offset, Vector2(0.0, 0.0));
+            mat->set_shader_parameter(res.uniform.mask_tile_offset, Vector2(0.0, 0.0));
+        }
+    }
+}
+
+void InternalCubismRenderer2D::build_clip_item(
+    const Csm::CubismModel *model,
+    InternalCubismRendererResource &res,
+    InternalCubismClipContext &context,
+    const RID parent) const
+{
+    // the clip items draw the masks themselves, their alpha clips everything parented to them.
+    // they are created by update_clip_segments once the render order is known
+    context.clip_children = true;
+    context.clip_parent = parent;
+    context.clip_material = res.request_clip_material();
+
+    for (Csm::csmUint32 m = 0; m < context.masks.GetSize(); m++) {
+        this->build_mesh(model, context.masks[m], res);
+    }
+}
+
+void InternalCubismRenderer2D::add_clip_masks(
+    const Csm::CubismModel *model,
+    const InternalCubismRendererResource &res,
+    const InternalCubismClipContext &context,
+    const RID item) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    for (Csm::csmUint32 m = 0; m < context.masks.GetSize(); m++)
+    {
+        const Csm::csmInt32 j = context.masks[m];
+        const Ref<Texture2D> tex = res.ary_texture[model->GetDrawableTextureIndex(j)];
+        rs->canvas_item_add_mesh(
+            item,
+            res.ary_drawable_mesh[j].mesh->get_rid(),
+            Transform2D(), Color(1.0, 1.0, 1.0, 1.0), tex->get_rid());
     }
 }
 
-void InternalCubismRenderer2D::build_model(InternalCubismRendererResource &res, Node* target_node)
+void InternalCubismRenderer2D::build_canvas_item(
+    const Csm::CubismModel *model,
+    const Csm::csmInt32 index,
+    InternalCubismRendererResource &res,
+    const RID parent) const
+{
+    RenderingServer *rs = RenderingServer::get_singleton();
+    InternalCubismCanvasItem &item = res.ary_canvas_item[index];
+    Ref<ArrayMesh> mesh = this->build_mesh(model, index, res);
+
+    item.canvas_item = rs->canvas_item_create();
+    rs->canvas_item_set_parent(item.canvas_item, parent);
+    rs->canvas_item_add_mesh(item.canvas_item, mesh->get_rid());
+    rs->canvas_item_set_custom_rect(item.canvas_item, true, res.ary_drawable_mesh[index].bounds);
+
+    item.material = Ref<ShaderMaterial>(res.request_shader_material(model, index));
+    rs->canvas_item_set_material(item.canvas_item, item.material->get_rid());
+    res.ary_drawable_mesh[index].material = item.material.ptr();
+    res.ary_drawable_mesh[index].canvas_item = item.canvas_item;
+
+    // without a MeshInstance2D the meshes themselves are published, get_meshes() hands out ArrayMesh
+    CubismIdHandle handle = model->GetDrawableId(index);
+    res.dict_mesh[String(handle->GetString().GetRawString())] = mesh;
+}
+
+void InternalCubismRenderer2D::build_model_begin(InternalCubismRendererResource &res, const bool hidden)
 {
     const CubismModel *model = this->GetModel();
-    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
-    const Csm::csmInt32 *maskCount = model->GetDrawableMaskCounts();
 
     this->make_ArrayMesh_prepare(
         model,
         res);
 
-    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++)
-    {
-        if (model->GetDrawableVertexCount(index) == 0)
-            continue;
-        if (model->GetDrawableVertexIndexCount(index) == 0)
-            continue;
+    res.ary_drawable_mesh.Clear();
+    res.ary_drawable_mesh.Resize(model->GetDrawableCount());
+    res.force_update = true;
+    res.build_hidden = hidden;
+
+    // clipped drawables have to be reparented to their clip parent, which only bare canvas items allow
+    res.mask_mode = res._owner_viewport->get_mask_mode_built();
+    res.use_rendering_server =
+        res._owner_viewport->get_rendering_backend() == GDCubismUserModel::RENDERING_BACKEND_SERVER ||
+        res.mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN;
+    res.use_batching = res._owner_viewport->get_batching();
+    res.ary_batch.Clear();
+    res.ary_canvas_item.Clear();
+    if (res.use_rendering_server) {
+        res.ary_canvas_item.Resize(model->GetDrawableCount());
+    }
 
-        CubismIdHandle handle = model->GetDrawableId(index);
-        String node_name(handle->GetString().GetRawString());
+    // materials are shared per clip context, which has to be known before the drawables are built
+    this->group_clip_context(model, res);
+}
 
-        MeshInstance2D* node = res.request_mesh_instance();
-        ShaderMaterial* mat = res.request_shader_material(model, index);
-        node->set_material(mat);        
-        this->update_mesh(model, index, false, res, node);
-        node->set_name(node_name);
+void InternalCubismRenderer2D::build_model_drawable(InternalCubismRendererResource &res, Node* target_node, const Csm::csmInt32 index)
+{
+    const CubismModel *model = this->GetModel();
 
-        // build mask
-        if (model->GetDrawableMaskCounts()[index] > 0)
-        {
-            TypedArray<MeshInstance2D> masks;
-            masks.resize(model->GetDrawableMaskCounts()[index]);
-            
-            SubViewport* viewport = memnew(SubViewport);
-            {
-                viewport->set_disable_3d(SUBVIEWPORT_DISABLE_3D_FLAG);
-                viewport->set_clear_mode(SubViewport::ClearMode::CLEAR_MODE_ALWAYS);
-                // set_update_mode must be specified
-                viewport->set_update_mode(SubViewport::UpdateMode::UPDATE_ALWAYS);
-                viewport->set_disable_input(true);
-                // Memory leak when set_use_own_world_3d is true
-                // https://github.com/godotengine/godot/issues/81476
-                viewport->set_use_own_world_3d(SUBVIEWPORT_USE_OWN_WORLD_3D_FLAG);
-                // Memory leak when set_transparent_background is true(* every time & window minimize)
-                // https://github.com/godotengine/godot/issues/89651
-                viewport->set_transparent_background(true);
-
-                for (Csm::csmInt32 m_index = 0; m_index < model->GetDrawableMaskCounts()[index]; m_index++)
-                {
-                    Csm::csmInt32 j = model->GetDrawableMasks()[index][m_index];
-                    
-                    if (model->GetDrawableVertexCount(j) == 0)
-                        continue;
-                    if (model->GetDrawableVertexIndexCount(j) == 0)
-                        continue;
-            
-                    CubismIdHandle handle = model->GetDrawableId(j);
-                    String mask_name(handle->GetString().GetRawString());
-
-                    MeshInstance2D *node = res.request_mesh_instance();
-                    ShaderMaterial *mat = res.request_mask_material();
-                    this->update_mesh(model, j, true, res, node);
-
-                    node->set_name(mask_name);
-                    node->set_material(mat);
-                    mat->set_shader_parameter("channel", Vector4(0.0, 0.0, 0.0, 1.0));
-                    mat->set_shader_parameter("tex_main", res.ary_texture[model->GetDrawableTextureIndex(index)]);
-
-                    node->set_z_index(model->GetDrawableRenderOrders()[index]);
-                    node->set_visible(true);
-
-                    masks[m_index] = node;
-
-                    viewport->add_child(node);
-                    res.managed_nodes.append(node);
-                }
+    if (model->GetDrawableVertexCount(index) == 0)
+        return;
+    if (model->GetDrawableVertexIndexCount(index) == 0)
+        return;
+
+    if (res.use_rendering_server) {
+        this->build_canvas_item(model, index, res, Object::cast_to<CanvasItem>(target_node)->get_canvas_item());
+        if (res.build_hidden) RenderingServer::get_singleton()->canvas_item_set_visible(res.ary_drawable_mesh[index].canvas_item, false);
+        return;
+    }
+
+    CubismIdHandle handle = model->GetDrawableId(index);
+    String node_name(handle->GetString().GetRawString());
+
+    MeshInstance2D* node = res.request_mesh_instance(this->build_mesh(model, index, res));
+    ShaderMaterial* mat = res.request_shader_material(model, index);
+    node->set_material(mat);        
+    res.ary_drawable_mesh[index].material = mat;
+    res.ary_drawable_mesh[index].node = node;
+    res.ary_drawable_mesh[index].canvas_item = node->get_canvas_item();
+    RenderingServer::get_singleton()->canvas_item_set_custom_rect(
+        node->get_canvas_item(), true,
+        res.ary_drawable_mesh[index].bounds
+    );
+    node->set_name(node_name);
+    node->set_visible(!res.build_hidden);
+
+    res.dict_mesh[node_name] = node;
+    target_node->add_child(node);
+    res.managed_nodes.append(node);
+}
+
+void InternalCubismRenderer2D::build_model_end(InternalCubismRendererResource &res, Node* target_node, Csm::ICubismModelSetting *setting)
+{
+    const CubismModel *model = this->GetModel();
+
+    this->build_clip_context(model, res, target_node);
+
+    if (res.use_batching) {
+        // anything read through its own mesh has to keep it, masks by their mask items, hit areas by get_meshes
+        for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++) {
+            InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+            drawable.batchable = drawable.mesh.is_valid() && model->GetDrawableMaskCounts()[index] == 0;
+        }
+        for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++) {
+            const InternalCubismClipContext &context = res.ary_clip_context[c];
+            for (Csm::csmUint32 m = 0; m < context.masks.GetSize(); m++) {
+                res.ary_drawable_mesh[context.masks[m]].batchable = false;
             }
+        }
+
+        for (Csm::csmInt32 i = 0; setting != nullptr && i < setting->GetHitAreasCount(); i++) {
+            const Csm::csmInt32 index = model->GetDrawableIndex(setting->GetHitAreaId(i));
+            if (index >= 0) res.ary_drawable_mesh[index].batchable = false;
+        }
+    }
+}
 
-            target_node->add_child(viewport);
-            res.managed_nodes.append(viewport);
+bool InternalCubismRenderer2D::check_layout(const Csm::CubismModel *model) const
+{
+    const CubismModel *built = this->GetModel();
+    if (built == nullptr || model == nullptr) return false;
 
-            viewport->set_name(node_name + "__mask");
-            res.dict_mask[node_name] = masks;
+    const Csm::csmInt32 count = built->GetDrawableCount();
+    if (model->GetDrawableCount() != count) return false;
 
-            node->set_meta("viewport", viewport);
+    // vertices are placed by the canvas, its size is baked into the mask setup
+    if (this->get_size(model) != this->get_size(built)) return false;
+    if (this->get_origin(model) != this->get_origin(built)) return false;
+    if (this->get_ppunit(model) != this->get_ppunit(built)) return false;
 
-            // canvas transform only available after the viewport canvas has been initialized
-            // on load the mask will not be the right size or offset, but will be corrected immediately on first update
-            Vector2i viewport_size = Vector2i(1,1);
-            Vector2 viewport_offset = Vector2(0,0);
-            viewport->set_size(viewport_size);
-            
-            mat->set_shader_parameter("tex_mask", viewport->get_texture());
-            mat->set_shader_parameter("canvas_size", Vector2(res.vct_canvas_size));
-            mat->set_shader_parameter("mesh_offset", viewport_offset);
+    for (Csm::csmInt32 index = 0; index < count; index++)
+    {
+        // ids are interned, the same id is the same handle
+        if (model->GetDrawableId(index) != built->GetDrawableId(index)) return false;
+        if (model->GetDrawableTextureIndex(index) != built->GetDrawableTextureIndex(index)) return false;
+        if (model->GetDrawableBlendMode(index) != built->GetDrawableBlendMode(index)) return false;
+        if (model->GetDrawableInvertedMask(index) != built->GetDrawableInvertedMask(index)) return false;
+
+        const Csm::csmInt32 mask_count = built->GetDrawableMaskCounts()[index];
+        if (model->GetDrawableMaskCounts()[index] != mask_count) return false;
+        for (Csm::csmInt32 m = 0; m < mask_count; m++) {
+            if (model->GetDrawableMasks()[index][m] != built->GetDrawableMasks()[index][m]) return false;
         }
 
-        res.dict_mesh[node_name] = node;
-        target_node->add_child(node);
-        res.managed_nodes.append(node);
+        // uv and index data were uploaded once when the meshes were built
+        const Csm::csmInt32 vertex_count = built->GetDrawableVertexCount(index);
+        const Csm::csmInt32 index_count = built->GetDrawableVertexIndexCount(index);
+        if (model->GetDrawableVertexCount(index) != vertex_count) return false;
+        if (model->GetDrawableVertexIndexCount(index) != index_count) return false;
+        if (vertex_count > 0 && memcmp(
+                model->GetDrawableVertexUvs(index),
+                built->GetDrawableVertexUvs(index),
+                vertex_count * sizeof(Live2D::Cubism::Core::csmVector2)) != 0) return false;
+        if (index_count > 0 && memcmp(
+                model->GetDrawableVertexIndices(index),
+                built->GetDrawableVertexIndices(index),
+                index_count * sizeof(csmUint16)) != 0) return false;
     }
+
+    return true;
+}
+
+void InternalCubismRenderer2D::rebind_model(InternalCubismRendererResource &res)
+{
+    const CubismModel *model = this->GetModel();
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    // the capture shows the previous textures
+    res.release_impostor();
+
+    for (Csm::csmUint32 i = 0; i < res.ary_shared_material.GetSize(); i++)
+    {
+        InternalCubismSharedMaterial &shared = res.ary_shared_material[i];
+        shared.material->set_shader_parameter(res.uniform.tex_main, res.ary_texture[shared.texture]);
+    }
+
+    for (Csm::csmUint32 c = 0; c < res.ary_clip_context.GetSize(); c++)
+    {
+        InternalCubismClipContext &context = res.ary_clip_context[c];
+        for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++) {
+            InternalCubismMaskItem &item = context.items[m];
+            item.material->set_shader_parameter(res.uniform.tex_main, res.ary_texture[model->GetDrawableTextureIndex(item.drawable)]);
+        }
+
+        // the clip items draw the masks with their texture bound per mesh, see add_clip_masks
+        for (Csm::csmUint32 g = 0; g < context.segments.GetSize(); g++) {
+            rs->canvas_item_clear(context.segments[g].clip_item);
+            this->add_clip_masks(model, res, context, context.segments[g].clip_item);
+        }
+    }
+
+    // vertices, colors, visibility and order all come from the new moc with the next update
+    for (Csm::csmUint32 i = 0; i < res.ary_drawable_mesh.GetSize(); i++) {
+        res.ary_drawable_mesh[i].color_valid = false;
+    }
+    res.interpolation_seeded = false;
+    res.has_model_bounds = false;
+    res.force_update = true;
 }
 
 void InternalCubismRenderer2D::Initialize(Csm::CubismModel *model, Csm::csmInt32 maskBufferCount)
@@ -393,4 +1868,76 @@ const Vector4 make_vector4(const Live2D::Cubism::Core::csmVector4 &src_vec4)
     return Vector4(src_vec4.X, src_vec4.Y, src_vec4.Z, src_vec4.W);
 }
 
+void write_Colors(uint8_t *dst, const int32_t stride, const int32_t size, const Vector4 &color)
+{
+    // RGBA8 unorm, the layout of both ARRAY_COLOR and the RGBA8 custom arrays
+    const uint8_t rgba[4] = {
+        uint8_t(CLAMP(color.x, 0.0f, 1.0f) * 255.0f + 0.5f),
+        uint8_t(CLAMP(color.y, 0.0f, 1.0f) * 255.0f + 0.5f),
+        uint8_t(CLAMP(color.z, 0.0f, 1.0f) * 255.0f + 0.5f),
+        uint8_t(CLAMP(color.w, 0.0f, 1.0f) * 255.0f + 0.5f)
+    };
+
+    for (int32_t i = 0; i < size; i++) {
+        memcpy(dst + i * stride, rgba, sizeof(rgba));
+    }
+}
+
+void write_UVs(uint8_t *dst, const int32_t stride, const PackedVector2Array &uv)
+{
+    // two floats, the layout of ARRAY_TEX_UV without attribute compression
+    for (int64_t i = 0; i < uv.size(); i++) {
+        const float value[2] = { float(uv[i].x), float(uv[i].y) };
+        memcpy(dst + i * stride, value, sizeof(value));
+    }
+}
+
+void set_mask_item_visible(InternalCubismMaskItem &item, const bool visible)
+{
+    if (item.node != nullptr) item.node->set_visible(visible);
+    else RenderingServer::get_singleton()->canvas_item_set_visible(item.canvas_item, visible);
+}
+
+void set_mask_item_transform(InternalCubismMaskItem &item, const Transform2D &transform, const Rect2 &bounds)
+{
+    if (item.node != nullptr) item.node->set_transform(transform);
+    else RenderingServer::get_singleton()->canvas_item_set_transform(item.canvas_item, transform);
+    // custom rect is in model space, the transform maps it onto the tile
+    RenderingServer::get_singleton()->canvas_item_set_custom_rect(item.canvas_item, true, bounds);
+}
+
+bool set_mask_target_size(InternalCubismMaskTarget &target, const Vector2i &size)
+{
+    // a resize reallocates the render target, so only forward real changes
+    if (target.size == size) return false;
+    target.size = size;
+
+    if (target.viewport != nullptr) target.viewport->set_size(size);
+    else RenderingServer::get_singleton()->viewport_set_size(target.viewport_rid, size.x, size.y);
+
+    return true;
+}
+
+Vector2i mask_size_class(const Vector2i &size, const int32_t max_size)
+{
+    // power of two per axis, capped at the model's mask size but never below what is required
+    Vector2i result(MASK_TARGET_SIZE_MIN, MASK_TARGET_SIZE_MIN);
+    while (result.x < size.x) result.x <<= 1;
+    while (result.y < size.y) result.y <<= 1;
+
+    if (max_size > 0) {
+        result.x = MAX(size.x, MIN(result.x, max_size));
+        result.y = MAX(size.y, MIN(result.y, max_size));
+    }
+
+    return result;
+}
+
+void request_mask_target_update(InternalCubismMaskTarget &target)
+{
+    // the server falls back to disabled after the next render
+    if (target.viewport != nullptr) target.viewport->set_update_mode(SubViewport::UpdateMode::UPDATE_ONCE);
+    else RenderingServer::get_singleton()->viewport_set_update_mode(target.viewport_rid, RenderingServer::VIEWPORT_UPDATE_ONCE);
+}
+
 #endif // GD_CUBISM_USE_RENDERER_2D
@@ -14,6 +14,7 @@
 #include <godot_cpp/classes/sub_viewport.hpp>
 #include <godot_cpp/classes/texture2d.hpp>
 
+#include <ICubismModelSetting.hpp>
 #include <Rendering/CubismRenderer.hpp>
 
 #include <private/internal_cubism_renderer_resource.hpp>
@@ -40,26 +41,154 @@ public:
 private:
     static void ready_mask(const MeshInstance2D *node);
 
-    void update_material(const Csm::CubismModel *model, const Csm::csmInt32 index, const Ref<ShaderMaterial> mat) const;
+    bool write_color(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res) const;
+
+    void update_color(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res) const;
     
     void make_ArrayMesh_prepare(
         const Csm::CubismModel *model,
         InternalCubismRendererResource &res);
 
+    Ref<ArrayMesh> build_mesh(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res) const;
+
+    bool write_mesh(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res) const;
+
+    void update_interpolation(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res) const;
+
     void update_mesh(
         const Csm::CubismModel *model,
         const Csm::csmInt32 index,
-        const bool makemask,
+        InternalCubismRendererResource &res) const;
+
+    void merge_model_bounds(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res) const;
+
+    bool update_batch(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        const bool force_update) const;
+
+    void build_batch(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        const Csm::csmVector<Csm::csmInt32> &run) const;
+
+    void release_batch(InternalCubismRendererResource &res) const;
+
+    void update_batched(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res,
+        const bool visible,
+        const bool visibility_changed,
+        const bool color_changed) const;
+
+    void flush_batch(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res) const;
+
+    void group_clip_context(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res) const;
+
+    void build_clip_context(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        Node *target_node) const;
+
+    void update_clip_context(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        const int32_t mask_viewport_size,
+        const bool force_update) const;
+
+    void update_clip_item(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context,
+        const bool order_changed,
+        const bool force_update) const;
+
+    // splits the clipped drawables into runs consecutive in render order, one clip item each
+    void update_clip_segments(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context) const;
+
+    void update_mask_layout(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context,
+        const Rect2 &bounds,
+        const Vector2 &tile_offset,
+        bool changed) const;
+
+    // false when no idle target has the size and resizing one is not allowed,
+    // the context is then left without a target
+    bool acquire_mask_target(
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context,
+        const Vector2i &size,
+        const bool allow_resize) const;
+
+    void release_mask_target(
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context) const;
+
+    void build_clip_item(
+        const Csm::CubismModel *model,
+        InternalCubismRendererResource &res,
+        InternalCubismClipContext &context,
+        const RID parent) const;
+
+    // draws the masks of the context into a clip_children canvas item, each with its own texture
+    void add_clip_masks(
+        const Csm::CubismModel *model,
         const InternalCubismRendererResource &res,
-        const MeshInstance2D *node) const;
+        const InternalCubismClipContext &context,
+        const RID item) const;
+
+    void build_canvas_item(
+        const Csm::CubismModel *model,
+        const Csm::csmInt32 index,
+        InternalCubismRendererResource &res,
+        const RID parent) const;
 
 public:
+    bool capture_impostor(InternalCubismRendererResource &res, const float scale) const;
+    // copies of the visible drawables below root, drawing the shared meshes with the shared materials
+    void build_mirror(InternalCubismRendererResource &res, const RID root, Csm::csmVector<RID> &items) const;
+
     Vector2 get_size(const Csm::CubismModel *model) const;
     Vector2 get_origin(const Csm::CubismModel *model) const;
     float get_ppunit(const Csm::CubismModel *model) const;
 
     void update(InternalCubismRendererResource &res, int32_t viewport_size = 0);
-    void build_model(InternalCubismRendererResource &res, Node *target_node);
+    // model_bounds from the current vertices, for a model that is updated without being drawn
+    void update_bounds(InternalCubismRendererResource &res) const;
+    // build_model_drawable is called for every drawable in between, drawables built hidden are shown by the next update
+    void build_model_begin(InternalCubismRendererResource &res, const bool hidden);
+    void build_model_drawable(InternalCubismRendererResource &res, Node *target_node, const Csm::csmInt32 index);
+    void build_model_end(InternalCubismRendererResource &res, Node *target_node, Csm::ICubismModelSetting *setting);
+    // model has the drawables, masks, uvs and indices of the one built, so it can take over what was built
+    bool check_layout(const Csm::CubismModel *model) const;
+    // what was built for the previous model, bound to this renderer's model and textures
+    void rebind_model(InternalCubismRendererResource &res);
 
     virtual void Initialize(Csm::CubismModel *model, Csm::csmInt32 maskBufferCount);
     void DoDrawModel();
@@ -3,18 +3,358 @@
 // ----------------------------------------------------------------- include(s)
 #include <gd_cubism.hpp>
 
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
 
-#ifdef GD_CUBISM_USE_RENDERER_3D
+#include <private/internal_cubism_renderer_3d.hpp>
 
 
 // ------------------------------------------------------------------ define(s)
 // --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
 // -------------------------------------------------------------------- enum(s)
 // ------------------------------------------------------------------- const(s)
 // ------------------------------------------------------------------ static(s)
+PackedInt32Array make_Indices(const Csm::csmUint16 *ptr, const int32_t &size);
+PackedVector2Array make_UVs(const Live2D::Cubism::Core::csmVector2 *ptr, const int32_t &size);
+
+
 // ----------------------------------------------------------- class:forward(s)
 // ------------------------------------------------------------------- class(s)
-// ------------------------------------------------------------------ method(s)
+InternalCubismRenderer3D::InternalCubismRenderer3D(GeometryInstance3D *owner)
+    : _owner(owner)
+    , pixel_size(0.001f)
+{
+    ResourceLoader *res_loader = ResourceLoader::get_singleton();
+
+    // the 3D shaders follow the 2D ones variant by variant, masks and clip parents are not drawn here
+    this->ary_shader.resize(GD_CUBISM_SHADER_MAX);
+
+    this->ary_shader[GD_CUBISM_SHADER_NORM_ADD] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_norm_add.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_NORM_MIX] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_norm_mix.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_NORM_MUL] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_norm_mul.gdshader");
+
+    this->ary_shader[GD_CUBISM_SHADER_MASK_ADD] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_add.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_MASK_ADD_INV] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_add_inv.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_MASK_MIX] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_mix.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_MASK_MIX_INV] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_mix_inv.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_MASK_MUL] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_mul.gdshader");
+    this->ary_shader[GD_CUBISM_SHADER_MASK_MUL_INV] = res_loader->load("res://addons/gd_cubism/res/shader/3d_cubism_mask_mul_inv.gdshader");
+}
+
+InternalCubismRenderer3D::~InternalCubismRenderer3D()
+{
+    this->clear();
+}
+
+void InternalCubismRenderer3D::clear()
+{
+    for (Csm::csmUint32 s = 0; s < this->ary_surface.GetSize(); s++)
+    {
+        MeshInstance3D *node = this->ary_surface[s].node;
+        if (node == nullptr) continue;
+        this->_owner->remove_child(node);
+        memdelete(node);
+    }
+    this->ary_surface.Clear();
+    this->ary_drawable.Clear();
+    this->ary_order.Clear();
+    this->aabb = AABB();
+}
+
+void InternalCubismRenderer3D::set_pixel_size(const float value)
+{
+    this->pixel_size = value;
+    for (Csm::csmUint32 s = 0; s < this->ary_surface.GetSize(); s++) {
+        this->ary_surface[s].material->set_shader_parameter("pixel_size", value);
+    }
+    // picked up again from the model bounds with the next update
+    this->aabb = AABB();
+}
+
+bool InternalCubismRenderer3D::check_order(const Csm::CubismModel *model) const
+{
+    if (this->ary_order.GetSize() != Csm::csmUint32(model->GetDrawableCount())) return false;
+
+    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++) {
+        if (this->ary_order[renderOrder[index]] != index) return false;
+    }
+    return true;
+}
+
+void InternalCubismRenderer3D::build(
+    const Csm::CubismModel *model,
+    const InternalCubismRendererResource &res)
+{
+    this->clear();
+
+    const Csm::csmInt32 *renderOrder = model->GetDrawableRenderOrders();
+    this->ary_order.Resize(model->GetDrawableCount(), -1);
+    for (Csm::csmInt32 index = 0; index < model->GetDrawableCount(); index++) {
+        this->ary_order[renderOrder[index]] = index;
+    }
+    this->ary_drawable.Resize(model->GetDrawableCount(), InternalCubismDrawable3D());
+
+    // drawables next to each other in render order and sharing their material become one surface,
+    // the surfaces are drawn in the order they were added
+    Csm::csmVector<Csm::csmInt32> run;
+    for (Csm::csmUint32 i = 0; i < this->ary_order.GetSize(); i++)
+    {
+        const Csm::csmInt32 index = this->ary_order[i];
+        const InternalCubismDrawableMesh &drawable = res.ary_drawable_mesh[index];
+        if (drawable.mesh.is_null() || drawable.material == nullptr) continue;
+
+        if (run.GetSize() > 0 && res.ary_drawable_mesh[run[0]].material != drawable.material) {
+            this->build_surface(model, res, run);
+            run.Clear();
+        }
+        run.PushBack(index);
+    }
+    if (run.GetSize() > 0) {
+        this->build_surface(model, res, run);
+    }
+}
+
+void InternalCubismRenderer3D::build_surface(
+    const Csm::CubismModel *model,
+    const InternalCubismRendererResource &res,
+    const Csm::csmVector<Csm::csmInt32> &run)
+{
+    const Csm::csmInt32 s = this->ary_surface.GetSize();
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    this->ary_surface.PushBack(InternalCubismSurface3D());
+    InternalCubismSurface3D &surface = this->ary_surface[s];
+
+    int32_t vertex_count = 0;
+    PackedVector2Array ary_uv;
+    PackedInt32Array ary_index;
+    for (Csm::csmUint32 i = 0; i < run.GetSize(); i++)
+    {
+        const Csm::csmInt32 index = run[i];
+        InternalCubismDrawable3D &drawable = this->ary_drawable[index];
+        drawable.surface = s;
+        drawable.first_vertex = vertex_count;
+        surface.drawables.PushBack(index);
+
+        ary_uv.append_array(make_UVs(
+            model->GetDrawableVertexUvs(index),
+            model->GetDrawableVertexCount(index)));
+
+        PackedInt32Array indices = make_Indices(
+            model->GetDrawableVertexIndices(index),
+            model->GetDrawableVertexIndexCount(index));
+        for (int64_t j = 0; j < indices.size(); j++) {
+            indices[j] += vertex_count;
+        }
+        ary_index.append_array(indices);
 
+        vertex_count += model->GetDrawableVertexCount(index);
+    }
 
-#endif // GD_CUBISM_USE_RENDERER_3D
+    // positions stay in canvas pixels with z at zero, the shader places them in the scene
+    PackedVector3Array ary_vertex;
+    ary_vertex.resize(vertex_count);
+    ary_vertex.fill(Vector3(0.0, 0.0, 0.0));
+    PackedColorArray ary_color;
+    ary_color.resize(vertex_count);
+    ary_color.fill(Color(1.0, 1.0, 1.0, 1.0));
+    PackedByteArray ary_custom;
+    ary_custom.resize(vertex_count * 4);
+    ary_custom.fill(0);
+
+    Array ary;
+    ary.resize(Mesh::ARRAY_MAX);
+    ary[Mesh::ARRAY_VERTEX] = ary_vertex;
+    ary[Mesh::ARRAY_TEX_UV] = ary_uv;
+    ary[Mesh::ARRAY_INDEX] = ary_index;
+    ary[Mesh::ARRAY_COLOR] = ary_color;
+    ary[Mesh::ARRAY_CUSTOM0] = ary_custom;
+    ary[Mesh::ARRAY_CUSTOM1] = ary_custom;
+
+    surface.mesh.instantiate();
+    surface.mesh->add_surface_from_arrays(
+        Mesh::PRIMITIVE_TRIANGLES, ary,
+        TypedArray<Array>(), Dictionary(),
+        Mesh::ARRAY_FLAG_USE_DYNAMIC_UPDATE |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) |
+        (Mesh::ARRAY_CUSTOM_RGBA8_UNORM << Mesh::ARRAY_FORMAT_CUSTOM1_SHIFT));
+
+    // the attribute stream has the layout of the 2D meshes, only the vertex stream gained a z.
+    // both are laid out here, reading the surface back would stall on the gpu
+    const int64_t format = static_cast<int64_t>(surface.mesh->surface_get_format(0));
+    surface.stride = rs->mesh_surface_get_format_vertex_stride(format, vertex_count);
+    surface.attribute_stride = rs->mesh_surface_get_format_attribute_stride(format, vertex_count);
+    surface.vertex.resize(surface.stride * vertex_count);
+    surface.vertex.fill(0);
+    surface.attribute.resize(surface.attribute_stride * vertex_count);
+    surface.attribute.fill(0);
+
+    const InternalCubismDrawableMesh &first = res.ary_drawable_mesh[run[0]];
+    ERR_FAIL_COND(surface.attribute_stride != first.attribute_stride);
+
+    // every vertex belongs to one member, whose uv and colors are copied over the whole stream
+    for (Csm::csmUint32 i = 0; i < run.GetSize(); i++)
+    {
+        const InternalCubismDrawableMesh &source = res.ary_drawable_mesh[run[i]];
+        InternalCubismDrawable3D &drawable = this->ary_drawable[run[i]];
+        memcpy(
+            surface.attribute.ptrw() + drawable.first_vertex * surface.attribute_stride,
+            source.attribute.ptr(),
+            source.attribute.size());
+        drawable.color_revision = source.color_revision;
+    }
+    surface.vertex_dirty = true;
+    surface.attribute_dirty = true;
+
+    surface.source = first.material;
+    GDCubismShader e = GD_CUBISM_SHADER_NORM_MIX;
+    for (Csm::csmUint32 i = 0; i < res.ary_shared_material.GetSize(); i++) {
+        if (res.ary_shared_material[i].material.ptr() == first.material) {
+            e = static_cast<GDCubismShader>(res.ary_shared_material[i].shader);
+            break;
+        }
+    }
+    surface.masked = e != GD_CUBISM_SHADER_NORM_ADD && e != GD_CUBISM_SHADER_NORM_MIX && e != GD_CUBISM_SHADER_NORM_MUL;
+
+    surface.material.instantiate();
+    surface.material->set_shader(this->ary_shader[e]);
+    surface.material->set_shader_parameter(res.uniform.tex_main, first.material->get_shader_parameter(res.uniform.tex_main));
+    surface.material->set_shader_parameter(res.uniform.channel, first.material->get_shader_parameter(res.uniform.channel));
+    surface.material->set_shader_parameter("pixel_size", this->pixel_size);
+    surface.mesh->surface_set_material(0, surface.material);
+
+    surface.node = memnew(MeshInstance3D);
+    surface.node->set_mesh(surface.mesh);
+    this->update_instance(s, surface);
+    this->_owner->add_child(surface.node, false, Node::INTERNAL_MODE_BACK);
+}
+
+void InternalCubismRenderer3D::update_instance(
+    const Csm::csmInt32 s,
+    InternalCubismSurface3D &surface) const
+{
+    // the runs share their origin, so the offset alone orders them when the scene sorts by depth.
+    // material priorities are left to the user, they would also override the depth against the rest of the scene
+    MeshInstance3D *node = surface.node;
+    const float sorting_offset = this->_owner->get_sorting_offset() + s * MESH_3D_SORTING_STEP;
+    if (node->is_sorting_use_aabb_center()) node->set_sorting_use_aabb_center(false);
+    if (node->get_sorting_offset() != sorting_offset) node->set_sorting_offset(sorting_offset);
+    if (node->get_layer_mask() != this->_owner->get_layer_mask()) node->set_layer_mask(this->_owner->get_layer_mask());
+    if (node->get_cast_shadows_setting() != this->_owner->get_cast_shadows_setting()) node->set_cast_shadows_setting(this->_owner->get_cast_shadows_setting());
+    if (node->get_material_override() != this->_owner->get_material_override()) node->set_material_override(this->_owner->get_material_override());
+    if (node->get_transparency() != this->_owner->get_transparency()) node->set_transparency(this->_owner->get_transparency());
+}
+
+void InternalCubismRenderer3D::update_mask(
+    const InternalCubismRendererResource &res,
+    InternalCubismSurface3D &surface) const
+{
+    // the masks are the ones rendered for the 2D model, sampled the same way from the canvas position
+    const StringName *names[] = {
+        &res.uniform.tex_mask,
+        &res.uniform.mask_scale,
+        &res.uniform.canvas_size,
+        &res.uniform.mesh_offset,
+        &res.uniform.mask_tile_offset,
+        &res.uniform.channel
+    };
+    for (const StringName *name : names)
+    {
+        const Variant value = surface.source->get_shader_parameter(*name);
+        if (surface.material->get_shader_parameter(*name) != value) {
+            surface.material->set_shader_parameter(*name, value);
+        }
+    }
+}
+
+void InternalCubismRenderer3D::update(
+    const Csm::CubismModel *model,
+    const InternalCubismRendererResource &res,
+    const bool structure_changed)
+{
+    // visibility changes are handled in place, only a new render order regroups the surfaces
+    if (this->ary_drawable.GetSize() == 0 || (structure_changed && this->check_order(model) == false)) {
+        this->build(model, res);
+    }
+
+    RenderingServer *rs = RenderingServer::get_singleton();
+
+    for (Csm::csmUint32 s = 0; s < this->ary_surface.GetSize(); s++)
+    {
+        InternalCubismSurface3D &surface = this->ary_surface[s];
+
+        for (Csm::csmUint32 i = 0; i < surface.drawables.GetSize(); i++)
+        {
+            const Csm::csmInt32 index = surface.drawables[i];
+            const InternalCubismDrawableMesh &source = res.ary_drawable_mesh[index];
+            InternalCubismDrawable3D &drawable = this->ary_drawable[index];
+            const int32_t vertex_count = model->GetDrawableVertexCount(index);
+
+            if (drawable.color_revision != source.color_revision) {
+                memcpy(
+                    surface.attribute.ptrw() + drawable.first_vertex * surface.attribute_stride,
+                    source.attribute.ptr(),
+                    vertex_count * surface.attribute_stride);
+                drawable.color_revision = source.color_revision;
+                surface.attribute_dirty = true;
+            }
+
+            // the 2D pass only writes the drawables it shows, a hidden one is collapsed onto the origin
+            const bool visible =
+                source.lod_hidden == false &&
+                model->GetDrawableDynamicFlagIsVisible(index) &&
+                model->GetDrawableOpacity(index) > 0.0f;
+
+            uint8_t *dst = surface.vertex.ptrw() + drawable.first_vertex * surface.stride;
+            if (visible && (drawable.visible == false || drawable.vertex_revision != source.vertex_revision)) {
+                const uint8_t *src = source.vertex.ptr();
+                for (int32_t v = 0; v < vertex_count; v++) {
+                    memcpy(dst + v * surface.stride, src + v * source.stride, sizeof(float) * 2);
+                }
+                surface.vertex_dirty = true;
+            } else if (visible == false && drawable.visible) {
+                for (int32_t v = 0; v < vertex_count; v++) {
+                    memset(dst + v * surface.stride, 0, sizeof(float) * 2);
+                }
+                surface.vertex_dirty = true;
+            }
+            drawable.visible = visible;
+            drawable.vertex_revision = source.vertex_revision;
+        }
+
+        if (surface.vertex_dirty) {
+            rs->mesh_surface_update_vertex_region(surface.mesh->get_rid(), 0, 0, surface.vertex);
+            surface.vertex_dirty = false;
+        }
+        if (surface.attribute_dirty) {
+            rs->mesh_surface_update_attribute_region(surface.mesh->get_rid(), 0, 0, surface.attribute);
+            surface.attribute_dirty = false;
+        }
+        if (surface.masked) {
+            this->update_mask(res, surface);
+        }
+        this->update_instance(s, surface);
+    }
+
+    // culling goes by the visible drawables as the shader places them, y up and scaled
+    if (res.has_model_bounds) {
+        const Rect2 &bounds = res.model_bounds;
+        const AABB aabb(
+            Vector3(bounds.position.x, -bounds.get_end().y, 0.0) * this->pixel_size,
+            Vector3(bounds.size.x, bounds.size.y, 0.0) * this->pixel_size);
+        if (this->aabb != aabb) {
+            this->aabb = aabb;
+            for (Csm::csmUint32 s = 0; s < this->ary_surface.GetSize(); s++) {
+                this->ary_surface[s].mesh->set_custom_aabb(aabb);
+            }
+        }
+    }
+}
+
+
+// ------------------------------------------------------------------ method(s)
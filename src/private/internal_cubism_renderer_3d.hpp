@@ -7,14 +7,90 @@
 // ----------------------------------------------------------------- include(s)
 #include <gd_cubism.hpp>
 
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/shader_material.hpp>
+
+#include <Model/CubismModel.hpp>
+#include <Type/csmVector.hpp>
+
+#include <private/internal_cubism_renderer_resource.hpp>
+
 
 // ------------------------------------------------------------------ define(s)
 // --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
 // -------------------------------------------------------------------- enum(s)
 // ------------------------------------------------------------------- const(s)
 // ------------------------------------------------------------------ static(s)
 // ----------------------------------------------------------- class:forward(s)
 // ------------------------------------------------------------------- class(s)
+struct InternalCubismSurface3D {
+    // a run of drawables consecutive in render order and drawn with the same 2D material,
+    // hidden members keep their range in the buffers, collapsed to zero area.
+    // each run is a mesh instance of its own, the runs are kept in order by their sorting offset
+    Csm::csmVector<Csm::csmInt32> drawables;
+    Ref<ArrayMesh> mesh;
+    MeshInstance3D *node = nullptr;
+    PackedByteArray vertex;
+    PackedByteArray attribute;
+    int32_t stride = 0;
+    int32_t attribute_stride = 0;
+    bool vertex_dirty = false;
+    bool attribute_dirty = false;
+    Ref<ShaderMaterial> material;
+    // shared 2D material of the members, the mask uniforms are taken over from it
+    ShaderMaterial *source = nullptr;
+    bool masked = false;
+};
+
+
+struct InternalCubismDrawable3D {
+    Csm::csmInt32 surface = -1;
+    int32_t first_vertex = 0;
+    // revisions of the 2D drawable as last copied
+    uint32_t vertex_revision = 0;
+    uint32_t color_revision = 0;
+    bool visible = false;
+};
+
+
+class InternalCubismRenderer3D
+{
+public:
+    InternalCubismRenderer3D(GeometryInstance3D *owner);
+    ~InternalCubismRenderer3D();
+
+private:
+    // the node the run instances are internal children of, its instance settings are passed on to them
+    GeometryInstance3D *_owner;
+    Array ary_shader;
+    Csm::csmVector<InternalCubismSurface3D> ary_surface;
+    Csm::csmVector<InternalCubismDrawable3D> ary_drawable;
+    // drawable indices in render order as the surfaces were built for
+    Csm::csmVector<Csm::csmInt32> ary_order;
+    float pixel_size;
+    AABB aabb;
+
+private:
+    bool check_order(const Csm::CubismModel *model) const;
+    void build(const Csm::CubismModel *model, const InternalCubismRendererResource &res);
+    void build_surface(
+        const Csm::CubismModel *model,
+        const InternalCubismRendererResource &res,
+        const Csm::csmVector<Csm::csmInt32> &run);
+    void update_mask(const InternalCubismRendererResource &res, InternalCubismSurface3D &surface) const;
+    void update_instance(const Csm::csmInt32 s, InternalCubismSurface3D &surface) const;
+
+public:
+    void set_pixel_size(const float value);
+    void clear();
+    void update(const Csm::CubismModel *model, const InternalCubismRendererResource &res, const bool structure_changed);
+};
+
+
 // ------------------------------------------------------------------ method(s)
 
 
@@ -3,12 +3,15 @@
 // ----------------------------------------------------------------- include(s)
 #include <gd_cubism.hpp>
 
+#include <godot_cpp/classes/rendering_server.hpp>
 #include <godot_cpp/classes/resource_loader.hpp>
 
 #include <CubismFramework.hpp>
 #include <Model/CubismModel.hpp>
 #include <Rendering/CubismRenderer.hpp>
 
+#include <private/internal_cubism_mask_budget.hpp>
+#include <private/internal_cubism_object_pool.hpp>
 #include <private/internal_cubism_renderer_resource.hpp>
 #include <gd_cubism_user_model.hpp>
 
@@ -23,6 +26,23 @@
 // ------------------------------------------------------------------- class(s)
 InternalCubismRendererResource::InternalCubismRendererResource(GDCubismUserModel *owner_viewport)
     : _owner_viewport(owner_viewport)
+    , use_batching(false)
+    , use_rendering_server(false)
+    , mask_mode(0)
+    , mask_budget_scale(1.0f)
+    , force_update(true)
+    , build_hidden(false)
+    , meshes_exposed(false)
+    , has_model_bounds(false)
+    , lod_area_min(0.0f)
+    , lod_mask_scale(1.0f)
+    , use_interpolation(false)
+    , interpolation_step(false)
+    , interpolation_alpha(1.0f)
+    , interpolation_seeded(false)
+    , drawables_changed(true)
+    , structure_changed(true)
+    , use_mirrors(false)
 {
     ResourceLoader* res_loader = memnew(ResourceLoader);
 
@@ -41,6 +61,8 @@ InternalCubismRendererResource::InternalCubismRendererResource(GDCubismUserModel
     this->ary_shader[GD_CUBISM_SHADER_MASK_MUL] = res_loader->load("res://addons/gd_cubism/res/shader/2d_cubism_mask_mul.gdshader");
     this->ary_shader[GD_CUBISM_SHADER_MASK_MUL_INV] = res_loader->load("res://addons/gd_cubism/res/shader/2d_cubism_mask_mul_inv.gdshader");
 
+    this->ary_shader[GD_CUBISM_SHADER_CLIP] = res_loader->load("res://addons/gd_cubism/res/shader/2d_cubism_clip.gdshader");
+
     memdelete(res_loader);
 }
 
@@ -53,31 +75,228 @@ InternalCubismRendererResource::~InternalCubismRendererResource() {
 
 
 void InternalCubismRendererResource::clear() {
-    for (int i = 0; i < this->managed_nodes.size(); i++) {
+    this->release_impostor();
+
+    // back to front, so mask items leave their mask viewport before it is pooled
+    for (int64_t i = this->managed_nodes.size() - 1; i >= 0; i--) {
         Node *c = Object::cast_to<Node>(this->managed_nodes[i]);
-        c->get_parent()->remove_child(c);
-        c->queue_free();
+        MeshInstance2D *node = Object::cast_to<MeshInstance2D>(c);
+        SubViewport *viewport = Object::cast_to<SubViewport>(c);
+        if (node != nullptr && !this->meshes_exposed) {
+            InternalCubismObjectPool::release_mesh_instance(node);
+        } else if (viewport != nullptr) {
+            InternalCubismObjectPool::release_viewport(viewport);
+        } else {
+            if (c->get_parent() != nullptr) c->get_parent()->remove_child(c);
+            c->queue_free();
+        }
     }
 
     this->managed_nodes.clear();
+    this->meshes_exposed = false;
 
-    this->ary_texture.clear();
+    RenderingServer *rs = RenderingServer::get_singleton();
+    for (Csm::csmUint32 i = 0; i < this->ary_clip_context.GetSize(); i++) {
+        InternalCubismClipContext &context = this->ary_clip_context[i];
+        for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++) {
+            if (context.items[m].node == nullptr && context.items[m].canvas_item.is_valid()) rs->free_rid(context.items[m].canvas_item);
+        }
+    }
+    for (Csm::csmUint32 i = 0; i < this->ary_mask_target.GetSize(); i++) {
+        InternalCubismMaskTarget &target = this->ary_mask_target[i];
+        if (target.viewport != nullptr) continue;
+        if (target.viewport_rid.is_valid()) InternalCubismObjectPool::release_server_viewport(target.viewport_rid, target.canvas);
+    }
+    for (Csm::csmUint32 i = 0; i < this->ary_canvas_item.GetSize(); i++) {
+        if (this->ary_canvas_item[i].canvas_item.is_valid()) rs->free_rid(this->ary_canvas_item[i].canvas_item);
+    }
+    for (Csm::csmUint32 i = 0; i < this->ary_batch.GetSize(); i++) {
+        if (this->ary_batch[i].node == nullptr && this->ary_batch[i].canvas_item.is_valid()) rs->free_rid(this->ary_batch[i].canvas_item);
+    }
+    // clip parents last, once nothing is parented to them anymore
+    for (Csm::csmUint32 i = 0; i < this->ary_clip_context.GetSize(); i++) {
+        const InternalCubismClipContext &context = this->ary_clip_context[i];
+        for (Csm::csmUint32 s = 0; s < context.segments.GetSize(); s++) {
+            rs->free_rid(context.segments[s].clip_item);
+        }
+    }
+
+    // the nodes are gone, materials and meshes are pooled once these lists hold their last reference.
+    // clipped_materials and the canvas items only hold shared materials a second time
+    this->ary_canvas_item.Clear();
+    for (Csm::csmUint32 i = 0; i < this->ary_clip_context.GetSize(); i++) {
+        InternalCubismClipContext &context = this->ary_clip_context[i];
+        context.clipped_materials.Clear();
+        for (Csm::csmUint32 m = 0; m < context.items.GetSize(); m++) {
+            this->release_shader_material(context.items[m].material);
+        }
+        this->release_shader_material(context.clip_material);
+    }
+    for (Csm::csmUint32 i = 0; i < this->ary_shared_material.GetSize(); i++) {
+        this->release_shader_material(this->ary_shared_material[i].material);
+    }
+    for (Csm::csmUint32 i = 0; i < this->ary_batch.GetSize(); i++) {
+        this->release_array_mesh(this->ary_batch[i].mesh);
+    }
+    // get_meshes() hands out the meshes themselves with the RenderingServer backend
     this->dict_mesh.clear();
-    this->dict_mask.clear();
+    for (Csm::csmUint32 i = 0; i < this->ary_drawable_mesh.GetSize(); i++) {
+        this->release_array_mesh(this->ary_drawable_mesh[i].mesh);
+    }
+
+    this->ary_clip_context.Clear();
+    this->ary_shared_material.Clear();
+    this->ary_batch.Clear();
+    this->ary_mask_target.Clear();
+    this->ary_mask_target_idle.Clear();
+    this->mask_budget_scale = 1.0f;
+    InternalCubismMaskBudget::release(this);
+
+    this->ary_texture.clear();
+    this->ary_drawable_mesh.Clear();
+    this->has_model_bounds = false;
+    this->interpolation_seeded = false;
+    this->interpolation_scratch.clear();
+}
+
+void InternalCubismRendererResource::restore_node_names() {
+    // the names are the ones given at build time, godot made the ones in use unique
+    Array ary_name = this->dict_mesh.keys();
+    for (int64_t i = 0; i < ary_name.size(); i++) {
+        Node *node = Object::cast_to<Node>(this->dict_mesh[ary_name[i]]);
+        if (node != nullptr) node->set_name(ary_name[i]);
+    }
+    for (Csm::csmUint32 b = 0; b < this->ary_batch.GetSize(); b++) {
+        if (this->ary_batch[b].node == nullptr) continue;
+        this->ary_batch[b].node->set_name(String("__batch_") + String::num_int64(b));
+    }
+    for (Csm::csmUint32 t = 0; t < this->ary_mask_target.GetSize(); t++) {
+        if (this->ary_mask_target[t].viewport == nullptr) continue;
+        this->ary_mask_target[t].viewport->set_name(String("__mask_") + String::num_int64(t));
+    }
+}
+
+SubViewport* InternalCubismRendererResource::request_viewport() {
+    // pooled viewports are set up again as well, they may come from a model with other settings
+    SubViewport* viewport = InternalCubismObjectPool::request_viewport();
+
+    viewport->set_disable_3d(SUBVIEWPORT_DISABLE_3D_FLAG);
+    viewport->set_clear_mode(SubViewport::ClearMode::CLEAR_MODE_ALWAYS);
+    // set_update_mode must be specified
+    viewport->set_update_mode(SubViewport::UpdateMode::UPDATE_ALWAYS);
+    viewport->set_disable_input(true);
+    // Memory leak when set_use_own_world_3d is true
+    // https://github.com/godotengine/godot/issues/81476
+    viewport->set_use_own_world_3d(SUBVIEWPORT_USE_OWN_WORLD_3D_FLAG);
+    // Memory leak when set_transparent_background is true(* every time & window minimize)
+    // https://github.com/godotengine/godot/issues/89651
+    viewport->set_transparent_background(true);
+
+    return viewport;
+}
+
+void InternalCubismRendererResource::release_impostor() {
+    RenderingServer *rs = RenderingServer::get_singleton();
+    InternalCubismImpostor &impostor = this->impostor;
+
+    // copies first, then what they are parented to
+    for (Csm::csmUint32 i = 0; i < impostor.items.GetSize(); i++) {
+        rs->free_rid(impostor.items[i]);
+    }
+    impostor.items.Clear();
+    if (impostor.root.is_valid()) rs->free_rid(impostor.root);
+    if (impostor.sprite.is_valid()) rs->free_rid(impostor.sprite);
+    if (impostor.viewport.is_valid()) rs->free_rid(impostor.viewport);
+    if (impostor.canvas.is_valid()) rs->free_rid(impostor.canvas);
+
+    impostor.root = RID();
+    impostor.sprite = RID();
+    impostor.viewport = RID();
+    impostor.canvas = RID();
+    impostor.material.unref();
+    impostor.scale = 0.0f;
+
+    // the drawables were hidden behind the impostor, the next update shows them again
+    if (impostor.active) this->force_update = true;
+    impostor.active = false;
 }
 
-MeshInstance2D* InternalCubismRendererResource::request_mesh_instance() {
-    ArrayMesh* mesh = memnew(ArrayMesh);
-    MeshInstance2D* node = memnew(MeshInstance2D);
+Csm::csmInt32 InternalCubismRendererResource::request_mask_target(Node *target_node) {
+    InternalCubismMaskTarget target;
+    target.size = Vector2i(1, 1);
+
+    if (this->use_rendering_server) {
+        // same setup as request_viewport, without the node
+        RenderingServer *rs = RenderingServer::get_singleton();
+        if (InternalCubismObjectPool::request_server_viewport(target.viewport_rid, target.canvas) == false) {
+            target.viewport_rid = rs->viewport_create();
+            target.canvas = rs->canvas_create();
+            rs->viewport_attach_canvas(target.viewport_rid, target.canvas);
+        }
+        rs->viewport_set_disable_3d(target.viewport_rid, SUBVIEWPORT_DISABLE_3D_FLAG);
+        rs->viewport_set_clear_mode(target.viewport_rid, RenderingServer::VIEWPORT_CLEAR_ALWAYS);
+        rs->viewport_set_update_mode(target.viewport_rid, RenderingServer::VIEWPORT_UPDATE_DISABLED);
+        rs->viewport_set_transparent_background(target.viewport_rid, true);
+        rs->viewport_set_size(target.viewport_rid, target.size.x, target.size.y);
+        rs->viewport_set_active(target.viewport_rid, true);
+        target.texture = rs->viewport_get_texture(target.viewport_rid);
+    } else {
+        target.viewport = this->request_viewport();
+        target.viewport->set_size(target.size);
+        // masks are only rendered on demand, see InternalCubismRenderer2D::update_clip_context
+        target.viewport->set_update_mode(SubViewport::UpdateMode::UPDATE_DISABLED);
+        target.viewport->set_name(String("__mask_") + String::num_int64(this->ary_mask_target.GetSize()));
+        target_node->add_child(target.viewport);
+        this->managed_nodes.append(target.viewport);
+
+        target.viewport_rid = target.viewport->get_viewport_rid();
+        target.texture = target.viewport->get_texture()->get_rid();
+    }
+
+    this->ary_mask_target.PushBack(target);
+
+    return this->ary_mask_target.GetSize() - 1;
+}
+
+Ref<ArrayMesh> InternalCubismRendererResource::request_array_mesh() {
+    return InternalCubismObjectPool::request_array_mesh();
+}
+
+MeshInstance2D* InternalCubismRendererResource::request_mesh_instance(const Ref<ArrayMesh> &mesh) {
+    MeshInstance2D* node = InternalCubismObjectPool::request_mesh_instance();
     node->set_mesh(mesh);
     return node;
 }
 
+void InternalCubismRendererResource::release_mesh_instance(MeshInstance2D *node) {
+    this->managed_nodes.erase(node);
+    InternalCubismObjectPool::release_mesh_instance(node);
+}
+
+void InternalCubismRendererResource::release_array_mesh(Ref<ArrayMesh> &mesh) {
+    // still held elsewhere, by a script that got it from get_meshes() for one
+    if (mesh.is_valid() && mesh->get_reference_count() == 1) {
+        InternalCubismObjectPool::release_array_mesh(mesh);
+    }
+    mesh.unref();
+}
+
+void InternalCubismRendererResource::release_shader_material(Ref<ShaderMaterial> &material) {
+    if (material.is_valid() && material->get_reference_count() == 1) {
+        this->uniform.clear(material.ptr());
+        InternalCubismObjectPool::release_shader_material(material);
+    }
+    material.unref();
+}
+
 ShaderMaterial* InternalCubismRendererResource::request_shader_material(const Csm::CubismModel *model, const Csm::csmInt32 index) {
-    ShaderMaterial* mat = memnew(ShaderMaterial);
-    
+    // drawables clipped by a clip_children parent are drawn as they are, the parent does the masking
+    const bool clipped_by_parent =
+        this->mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN &&
+        model->GetDrawableInvertedMask(index) == false;
+
     GDCubismShader e = GD_CUBISM_SHADER_NORM_MIX;
-    if (model->GetDrawableMaskCounts()[index] == 0)
+    if (model->GetDrawableMaskCounts()[index] == 0 || clipped_by_parent)
     {
         switch (model->GetDrawableBlendMode(index))
         {
@@ -132,19 +351,60 @@ ShaderMaterial* InternalCubismRendererResource::request_shader_material(const Cs
         }
     }
 
+    const int32_t texture = model->GetDrawableTextureIndex(index);
+    const Csm::csmInt32 clip_context =
+        model->GetDrawableMaskCounts()[index] == 0 || clipped_by_parent ? -1 : this->ary_drawable_mesh[index].clip_context;
+
     Ref<Shader> shader = this->_owner_viewport->get_shader(e);
+    const Csm::csmInt32 drawable = shader.is_null() ? -1 : index;
+    this->ary_drawable_mesh[index].color_uniform = shader.is_valid();
+
+    for (Csm::csmUint32 i = 0; i < this->ary_shared_material.GetSize(); i++) {
+        const InternalCubismSharedMaterial &shared = this->ary_shared_material[i];
+        if (
+            shared.shader == e &&
+            shared.texture == texture &&
+            shared.clip_context == clip_context &&
+            shared.drawable == drawable
+        ) {
+            return shared.material.ptr();
+        }
+    }
+
+    Ref<ShaderMaterial> mat = InternalCubismObjectPool::request_shader_material();
+
     if (shader.is_null())
         shader = this->get_shader(e);
 
     mat->set_shader(shader);
-    mat->set_shader_parameter("channel", Vector4(0.0, 0.0, 0.0, 1.0));
-    mat->set_shader_parameter("tex_main", this->ary_texture[model->GetDrawableTextureIndex(index)]);
+    mat->set_shader_parameter(this->uniform.channel, Vector4(0.0, 0.0, 0.0, 1.0));
+    mat->set_shader_parameter(this->uniform.tex_main, this->ary_texture[texture]);
+
+    InternalCubismSharedMaterial shared;
+    shared.shader = e;
+    shared.texture = texture;
+    shared.clip_context = clip_context;
+    shared.drawable = drawable;
+    shared.material = mat;
+    this->ary_shared_material.PushBack(shared);
+
+    return mat.ptr();
+}
+
+Ref<ShaderMaterial> InternalCubismRendererResource::request_clip_material() {
+    Ref<ShaderMaterial> mat = InternalCubismObjectPool::request_shader_material();
+
+    Ref<Shader> shader = this->_owner_viewport->get_shader(GD_CUBISM_SHADER_CLIP);
+    if (shader.is_null())
+        shader = this->get_shader(GD_CUBISM_SHADER_CLIP);
+
+    mat->set_shader(shader);
 
     return mat;
 }
 
-ShaderMaterial* InternalCubismRendererResource::request_mask_material() {
-    ShaderMaterial* mat = memnew(ShaderMaterial);
+Ref<ShaderMaterial> InternalCubismRendererResource::request_mask_material() {
+    Ref<ShaderMaterial> mat = InternalCubismObjectPool::request_shader_material();
 
     Ref<Shader> shader = this->_owner_viewport->get_shader(GD_CUBISM_SHADER_MASK);
     if (shader.is_null())
@@ -8,6 +8,7 @@
 #include <gd_cubism.hpp>
 
 #include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/canvas_item_material.hpp>
 #include <godot_cpp/classes/mesh_instance2d.hpp>
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/classes/shader.hpp>
@@ -15,6 +16,8 @@
 #include <godot_cpp/classes/sub_viewport.hpp>
 #include <godot_cpp/classes/texture2d.hpp>
 
+#include <Type/csmVector.hpp>
+
 #include <gd_cubism_effect.hpp>
 
 
@@ -32,17 +35,228 @@ class GDCubismUserModel;
 
 
 // ------------------------------------------------------------------- class(s)
+struct InternalCubismDrawableMesh {
+    // Built once per drawable and shared by the drawable node and every mask copy of it.
+    // UV and index data stay in the surface as created, only the vertex stream is rewritten.
+    Ref<ArrayMesh> mesh;
+    PackedByteArray vertex;
+    int32_t stride = 0;
+    Rect2 bounds;
+    // set from csmVertexPositionsDidChange, cleared once the vertex stream is uploaded
+    bool dirty = false;
+
+    // drawable colors live in the attribute stream (COLOR, CUSTOM0, CUSTOM1) next to the uv,
+    // they are rewritten only when one of them differs from what was last uploaded
+    PackedByteArray attribute;
+    int32_t attribute_stride = 0;
+    int32_t offset_color = 0;
+    int32_t offset_custom0 = 0;
+    int32_t offset_custom1 = 0;
+    Vector4 color_base;
+    Vector4 color_screen;
+    Vector4 color_multiply;
+    bool color_valid = false;
+    // drawn with a user supplied shader, which may still read the colors as uniforms
+    bool color_uniform = false;
+
+    // InternalCubismClipContext the drawable is clipped by, -1 when unmasked,
+    // and with clip_children the InternalCubismClipSegment of it drawing the drawable
+    Csm::csmInt32 clip_context = -1;
+    Csm::csmInt32 clip_segment = -1;
+
+    // shared material the drawable is drawn with, owned by ary_shared_material
+    ShaderMaterial *material = nullptr;
+    // what draws the drawable, the node is only set by the node backend, the canvas item by both.
+    // dict_mesh keys the same by drawable id, but only for get_meshes()
+    MeshInstance2D *node = nullptr;
+    RID canvas_item;
+    // neither masked, used as a mask nor a hit area, so nothing needs its own mesh to be current
+    bool batchable = false;
+    // InternalCubismBatch drawing this drawable in place of its own mesh, and its first vertex in there
+    Csm::csmInt32 batch = -1;
+    int32_t batch_vertex = 0;
+
+    // largest area the drawable was seen with, kept so the level of detail cutoff does not
+    // flicker with the pose, and whether the cutoff drops it in the current level
+    float lod_area = 0.0f;
+    bool lod_hidden = false;
+
+    // csmVector2 positions of the last two simulation steps, drawn blended in between them.
+    // moving is set while they differ, so only those drawables are written between steps
+    PackedFloat32Array position_from;
+    PackedFloat32Array position_to;
+    bool moving = false;
+
+    // bumped whenever vertex or attribute is written, for copies of the drawable kept elsewhere
+    uint32_t vertex_revision = 0;
+    uint32_t color_revision = 0;
+};
+
+
+struct InternalCubismBatch {
+    // a run of drawables consecutive in render order and sharing their material, drawn as one mesh.
+    // hidden members keep their range in the buffers, collapsed to zero area
+    Csm::csmVector<Csm::csmInt32> drawables;
+    Ref<ArrayMesh> mesh;
+    MeshInstance2D *node = nullptr;
+    RID canvas_item;
+    PackedByteArray vertex;
+    PackedByteArray attribute;
+    int32_t stride = 0;
+    int32_t attribute_stride = 0;
+    bool vertex_dirty = false;
+    bool attribute_dirty = false;
+    bool visible = false;
+};
+
+
+struct InternalCubismSharedMaterial {
+    // drawables only differ in their vertex attributes, the material is shared by everything drawn
+    // with the same shader and texture, masked ones additionally by everything reading the same mask
+    int32_t shader = 0;
+    int32_t texture = 0;
+    Csm::csmInt32 clip_context = -1;
+    // a user supplied shader gets a material per drawable, it may read the color uniforms
+    Csm::csmInt32 drawable = -1;
+    Ref<ShaderMaterial> material;
+};
+
+
+struct InternalCubismUniformNames {
+    // interned once per model instead of building a StringName from a C string on every upload
+    StringName channel = "channel";
+    StringName tex_main = "tex_main";
+    StringName tex_mask = "tex_mask";
+    StringName canvas_size = "canvas_size";
+    StringName mesh_offset = "mesh_offset";
+    StringName mask_scale = "mask_scale";
+    StringName mask_tile_offset = "mask_tile_offset";
+    StringName color_base = "color_base";
+    StringName color_screen = "color_screen";
+    StringName color_multiply = "color_multiply";
+
+    // drops every value above, so a pooled material keeps no texture alive
+    void clear(ShaderMaterial *material) const {
+        material->set_shader_parameter(channel, Variant());
+        material->set_shader_parameter(tex_main, Variant());
+        material->set_shader_parameter(tex_mask, Variant());
+        material->set_shader_parameter(canvas_size, Variant());
+        material->set_shader_parameter(mesh_offset, Variant());
+        material->set_shader_parameter(mask_scale, Variant());
+        material->set_shader_parameter(mask_tile_offset, Variant());
+        material->set_shader_parameter(color_base, Variant());
+        material->set_shader_parameter(color_screen, Variant());
+        material->set_shader_parameter(color_multiply, Variant());
+    }
+};
+
+
+struct InternalCubismCanvasItem {
+    // RenderingServer backend only, every RID here is owned by the resource and freed in clear().
+    RID canvas_item;
+    Ref<ShaderMaterial> material;
+};
+
+
+struct InternalCubismMaskItem {
+    // One mask drawable drawn into a mask target, either a MeshInstance2D node
+    // or a bare canvas item depending on the backend.
+    MeshInstance2D *node = nullptr;
+    RID canvas_item;
+    Ref<ShaderMaterial> material;
+    Csm::csmInt32 drawable = -1;
+};
+
+
+struct InternalCubismMaskTarget {
+    // SubViewport node, or a RenderingServer viewport drawing its own canvas
+    SubViewport *viewport = nullptr;
+    RID viewport_rid;
+    RID canvas;
+    RID texture;
+    Vector2i size;
+    // a context drawn into this target changed, it is rendered once at the end of the update
+    bool redraw = false;
+};
+
+
+struct InternalCubismClipSegment {
+    // a run of clipped drawables with nothing else between them in render order, drawn by one
+    // clip_children canvas item at the order of its first drawable. a context splits into as
+    // many as other drawables are interleaved with its clipped ones
+    RID clip_item;
+    Csm::csmInt32 z_base = 0;
+    bool active = false;
+};
+
+
+struct InternalCubismClipContext {
+    // drawable indices of the masks, and of the drawables clipped by them
+    Csm::csmVector<Csm::csmInt32> masks;
+    Csm::csmVector<Csm::csmInt32> clipped;
+    Csm::csmVector<Ref<ShaderMaterial>> clipped_materials;
+    Csm::csmVector<InternalCubismMaskItem> items;
+
+    // MASK_MODE_CLIP_CHILDREN, the masks are drawn by clip_children canvas items parenting the clipped ones.
+    // inverted contexts have no way to be expressed with clip_children and keep a mask target.
+    // segments past segment_count are left over from an earlier render order and kept hidden
+    bool inverted = false;
+    bool clip_children = false;
+    RID clip_parent;
+    Ref<ShaderMaterial> clip_material;
+    Csm::csmVector<InternalCubismClipSegment> segments;
+    Csm::csmUint32 segment_count = 0;
+
+    Csm::csmInt32 target = -1;
+    Vector4 channel = Vector4(0.0, 0.0, 0.0, 1.0);
+    // area of the target reserved for this context in pixels, and the model space it shows
+    Rect2 tile;
+    Rect2 bounds;
+    float scale = 1.0;
+    Transform2D transform;
+    // any clipped drawable is visible and on screen
+    bool active = false;
+};
+
+
+struct InternalCubismImpostor {
+    // a RenderingServer viewport drawing copies of the drawables once, its texture is all the model shows.
+    // the copies share meshes and materials with the drawables, they are rebuilt on every capture
+    RID viewport;
+    RID canvas;
+    RID root;
+    Csm::csmVector<RID> items;
+    RID sprite;
+    Ref<CanvasItemMaterial> material;
+    // on screen scale the capture was requested for, before it was limited to IMPOSTOR_SIZE_MAX
+    float scale = 0.0f;
+    bool active = false;
+};
+
+
 class InternalCubismRendererResource {
 public:
     InternalCubismRendererResource(GDCubismUserModel *owner_viewport);
     ~InternalCubismRendererResource();
 
     void clear();
+    void release_impostor();
+    // the nodes were built while the model they replace still held their names
+    void restore_node_names();
 
+    // backed by InternalCubismObjectPool, what is released here is handed out again to any model
     SubViewport* request_viewport();
-    MeshInstance2D* request_mesh_instance();
+    Csm::csmInt32 request_mask_target(Node *target_node);
+    Ref<ArrayMesh> request_array_mesh();
+    MeshInstance2D* request_mesh_instance(const Ref<ArrayMesh> &mesh);
     ShaderMaterial* request_shader_material(const Csm::CubismModel *model, const Csm::csmInt32 index);
-    ShaderMaterial* request_mask_material();
+    Ref<ShaderMaterial> request_mask_material();
+    Ref<ShaderMaterial> request_clip_material();
+
+    void release_mesh_instance(MeshInstance2D *node);
+    // the reference is dropped, the object is only pooled when nothing else holds it
+    void release_array_mesh(Ref<ArrayMesh> &mesh);
+    void release_shader_material(Ref<ShaderMaterial> &material);
 
     // Shader
     Ref<Shader> get_shader(const GDCubismShader e) const { return this->ary_shader[e]; }
@@ -54,7 +268,50 @@ public:
     Array ary_texture;
     Array ary_shader;
     Dictionary dict_mesh;
-    Dictionary dict_mask;
+    Csm::csmVector<InternalCubismDrawableMesh> ary_drawable_mesh;
+    InternalCubismUniformNames uniform;
+    Csm::csmVector<InternalCubismSharedMaterial> ary_shared_material;
+    // runs of unmasked drawables merged into one mesh each, rebuilt when the render order regroups them
+    bool use_batching;
+    Csm::csmVector<InternalCubismBatch> ary_batch;
+    Csm::csmVector<InternalCubismCanvasItem> ary_canvas_item;
+    // drawables are plain canvas items parented to the model instead of MeshInstance2D nodes
+    bool use_rendering_server;
+
+    // GDCubismUserModel::MaskMode the contexts were built for
+    int32_t mask_mode;
+    Csm::csmVector<InternalCubismClipContext> ary_clip_context;
+    Csm::csmVector<InternalCubismMaskTarget> ary_mask_target;
+    // targets not used by any context, kept at their size for reuse
+    Csm::csmVector<Csm::csmInt32> ary_mask_target_idle;
+    // linear scale handed out by the global mask budget, applied from the next update on
+    float mask_budget_scale;
+    // next update ignores the dynamic flags and refreshes every drawable
+    bool force_update;
+    // drawables are built hidden while the model is set up over several frames, the first update shows them
+    bool build_hidden;
+    // dict_mesh went out through get_meshes(), scripts may hold its nodes so they are freed instead of pooled
+    bool meshes_exposed;
+    // union of the visible drawables as of the last update, used for whole model culling
+    bool has_model_bounds;
+    Rect2 model_bounds;
+    // set by the current level of detail, the area cutoff is in model units
+    float lod_area_min;
+    float lod_mask_scale;
+    // set by the model when the simulation runs slower than the updates, interpolation_step
+    // when a step ran since the last update, interpolation_alpha the way from the previous one
+    bool use_interpolation;
+    bool interpolation_step;
+    float interpolation_alpha;
+    bool interpolation_seeded;
+    PackedFloat32Array interpolation_scratch;
+    // any drawable changed in the last update, the model only turns into its impostor while nothing does
+    bool drawables_changed;
+    // a drawable changed visibility or order, copies drawing the model have to be rebuilt
+    bool structure_changed;
+    InternalCubismImpostor impostor;
+    // copies of the model are drawn elsewhere, masks are kept even where the model itself is culled
+    bool use_mirrors;
 
     // Render parameters
     Vector2i vct_canvas_size;
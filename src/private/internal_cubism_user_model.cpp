@@ -3,16 +3,15 @@
 // ----------------------------------------------------------------- include(s)
 #include <gd_cubism.hpp>
 
-#include <godot_cpp/classes/file_access.hpp>
-#include <godot_cpp/classes/resource_loader.hpp>
-#include <godot_cpp/classes/image_texture.hpp>
-#include <godot_cpp/classes/image.hpp>
+#include <Effect/CubismPose.hpp>
+#include <Model/CubismModelUserData.hpp>
+#include <Physics/CubismPhysics.hpp>
 
 #ifdef GD_CUBISM_USE_RENDERER_2D
     #include <private/internal_cubism_renderer_2d.hpp>
-#else
-    #include <private/internal_cubism_renderer_3d.hpp>
 #endif // GD_CUBISM_USE_RENDERER_2D
+#include <private/internal_cubism_model_data.hpp>
+#include <private/internal_cubism_renderer_3d.hpp>
 #include <private/internal_cubism_user_model.hpp>
 
 
@@ -32,7 +31,9 @@ InternalCubismUserModel::InternalCubismUserModel(GDCubismUserModel *owner_viewpo
     , _renderer_resource(owner_viewport)
     , _owner_viewport(owner_viewport)
     , _model_pathname("")
-    , _model_setting(nullptr) {
+    , _model_setting(nullptr)
+    , _model_data(nullptr)
+    , _build_index(0) {
 
     _debugMode = false;
 }
@@ -40,39 +41,172 @@ InternalCubismUserModel::InternalCubismUserModel(GDCubismUserModel *owner_viewpo
 
 InternalCubismUserModel::~InternalCubismUserModel() {
     this->clear();
+    this->release_model();
 }
 
 
-bool InternalCubismUserModel::model_load(
-    const String &model_pathname
-) {
+bool InternalCubismUserModel::model_load(InternalCubismModelData &data) {
 
-    this->_model_pathname = model_pathname;
+    this->_model_pathname = data.model_pathname;
     this->_updating = true;
     this->_initialized = false;
     this->_model_setting = nullptr;
 
-    PackedByteArray buffer = FileAccess::get_file_as_bytes(this->_model_pathname);
-    if(buffer.size() == 0) return false;
+    if(data.setting == nullptr || data.moc == nullptr) return false;
 
     this->clear();
 
-    this->_model_setting = CSM_NEW CubismModelSettingJson(buffer.ptr(), buffer.size());
-
     // setup Live2D model
-    if (strcmp(this->_model_setting->GetModelFileName(), "") == 0) {
+    CubismModel *model = data.moc->CreateModel();
+    if(model == nullptr) return false;
+    this->model_adopt(data, model);
+
+    return this->model_setup(data);
+}
+
+
+bool InternalCubismUserModel::model_swap(InternalCubismModelData &data) {
+    if(this->IsInitialized() == false) return false;
+    if(data.setting == nullptr || data.moc == nullptr) return false;
+
+    // on a mismatch the data is left as it is, for loading the model anew
+    CubismModel *model = data.moc->CreateModel();
+    if(model == nullptr) return false;
+    if(this->check_swap(data.setting, model) == false) {
+        data.moc->DeleteModel(model);
+        return false;
+    }
+
+    // everything read from the old files goes as in clear(), except for the renderer resource
+    this->DeleteRenderer();
+    this->release_motions();
+    this->effect_term();
+    this->_list_eye_blink.Clear();
+    this->_list_lipsync.Clear();
+    this->_model_setting = nullptr;
+
+    CubismPhysics::Delete(this->_physics);
+    this->_physics = nullptr;
+    CubismPose::Delete(this->_pose);
+    this->_pose = nullptr;
+    CubismModelUserData::Delete(this->_modelUserData);
+    this->_modelUserData = nullptr;
+    CSM_DELETE(this->_modelMatrix);
+    this->_modelMatrix = nullptr;
+    this->release_model();
+
+    this->_updating = true;
+    this->_initialized = false;
+    this->model_adopt(data, model);
+
+    if(this->model_setup(data) == false) return false;
+
+    {
+        #ifdef GD_CUBISM_USE_RENDERER_2D
+        InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+        #else
+        #endif // GD_CUBISM_USE_RENDERER_2D
+
+        renderer->IsPremultipliedAlpha(false);
+        renderer->DrawModel();
+        renderer->rebind_model(this->_renderer_resource);
+    }
+
+    return true;
+}
+
+
+void InternalCubismUserModel::model_adopt(InternalCubismModelData &data, CubismModel *model) {
+    // the same as LoadModel, with the moc already revived by the data
+    this->_model_pathname = data.model_pathname;
+    this->_model_setting = data.setting;
+    this->_moc = data.moc;
+    this->_model = model;
+
+    this->_model->SaveParameters();
+    this->_modelMatrix = CSM_NEW CubismModelMatrix(this->_model->GetCanvasWidth(), this->_model->GetCanvasHeight());
+    this->_moc3_file_format_version = static_cast<GDCubismUserModel::moc3FileFormatVersion>(data.moc_version);
+}
+
+
+void InternalCubismUserModel::build(const bool hidden) {
+    this->build_begin(hidden);
+    while(this->build_step() == false) {}
+}
+
+
+void InternalCubismUserModel::build_begin(const bool hidden) {
+    // ------------------------------------------------------------------------
+    // The process to make the mesh available immediately after initialization.
+    // The process is almost the same as the InternalCubismUserModel::update_node() function.
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    renderer->IsPremultipliedAlpha(false);
+    renderer->DrawModel();
+    renderer->build_model_begin(this->_renderer_resource, hidden);
+    this->_build_index = 0;
+}
+
+
+bool InternalCubismUserModel::build_step() {
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    if(this->_build_index < this->_model->GetDrawableCount()) {
+        renderer->build_model_drawable(this->_renderer_resource, this->_owner_viewport, this->_build_index);
+        this->_build_index++;
         return false;
-    } else {
-        String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetModelFileName());
-        String moc3_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
+    }
+
+    // masks and batching need every drawable
+    renderer->build_model_end(this->_renderer_resource, this->_owner_viewport, this->_model_setting);
+
+    return true;
+}
+
+
+float InternalCubismUserModel::get_build_progress() const {
+    if(this->_model == nullptr || this->_model->GetDrawableCount() == 0) return 1.0f;
+    return float(this->_build_index) / float(this->_model->GetDrawableCount());
+}
 
-        buffer = FileAccess::get_file_as_bytes(moc3_pathname);
-        this->LoadModel(buffer.ptr(), buffer.size());
 
-        const Live2D::Cubism::Core::csmVersion version = Live2D::Cubism::Core::csmGetMocVersion(buffer.ptr(), buffer.size());
-        this->_moc3_file_format_version = static_cast<GDCubismUserModel::moc3FileFormatVersion>(version);
+bool InternalCubismUserModel::check_swap(Csm::ICubismModelSetting *setting, const Csm::CubismModel *model) {
+    // the same textures by index, hit areas decide which drawables may be batched
+    if(setting->GetTextureCount() != this->_model_setting->GetTextureCount()) return false;
+    if(setting->GetHitAreasCount() != this->_model_setting->GetHitAreasCount()) return false;
+    for(Csm::csmInt32 i = 0; i < setting->GetHitAreasCount(); i++) {
+        if(setting->GetHitAreaId(i) != this->_model_setting->GetHitAreaId(i)) return false;
     }
 
+    // the settings the nodes and materials were built for, changing one of them reloads the model
+    const InternalCubismRendererResource &res = this->_renderer_resource;
+    const int32_t mask_mode = this->_owner_viewport->get_mask_mode_built();
+    const bool use_rendering_server =
+        this->_owner_viewport->get_rendering_backend() == GDCubismUserModel::RENDERING_BACKEND_SERVER ||
+        mask_mode == GDCubismUserModel::MASK_MODE_CLIP_CHILDREN;
+    if(res.mask_mode != mask_mode) return false;
+    if(res.use_rendering_server != use_rendering_server) return false;
+    if(res.use_batching != this->_owner_viewport->get_batching()) return false;
+
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    const InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    return renderer->check_layout(model);
+}
+
+
+bool InternalCubismUserModel::model_setup(const InternalCubismModelData &data) {
+    // the files were read by the data, the objects needing Cubism ids are created here
+    this->_model_data = &data;
+
     // Expression
     if(this->_owner_viewport->enable_load_expressions == true) {
         this->expression_load();
@@ -104,6 +238,7 @@ bool InternalCubismUserModel::model_load(
     }
 
     if(this->_model_setting == nullptr || this->_modelMatrix == nullptr) {
+        this->_model_data = nullptr;
         this->clear();
         return false;
     }
@@ -118,60 +253,18 @@ bool InternalCubismUserModel::model_load(
     this->CreateRenderer();
 
     // Resource(Texture)
-    this->model_load_resource();
+    this->_renderer_resource.ary_texture = data.ary_texture.duplicate();
+    this->_model_data = nullptr;
 
     this->stop();
 
     this->_updating = false;
     this->_initialized = true;
 
-    // ------------------------------------------------------------------------
-    // The process to make the mesh available immediately after initialization.
-    // The process is almost the same as the InternalCubismUserModel::update_node() function.
-    {
-        #ifdef GD_CUBISM_USE_RENDERER_2D
-        InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
-        #else
-        #endif // GD_CUBISM_USE_RENDERER_2D
-
-        renderer->IsPremultipliedAlpha(false);
-        renderer->DrawModel();
-        renderer->build_model(this->_renderer_resource, this->_owner_viewport);
-    }
-    // ------------------------------------------------------------------------
-
     return true;
 }
 
 
-void InternalCubismUserModel::model_load_resource()
-{
-    ResourceLoader *res_loader = ResourceLoader::get_singleton();
-
-    this->_renderer_resource.ary_texture.clear();
-
-    for (csmInt32 index = 0; index < this->_model_setting->GetTextureCount(); index++)
-    {
-        if (strcmp(this->_model_setting->GetTextureFileName(index), "") == 0) continue;
-
-        String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetTextureFileName(index));
-        String texture_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
-
-        Ref<Texture2D> tex;
-        // allow dynamically loading image textures for models provided from disk or user data
-        if (!res_loader->exists(texture_pathname)) {
-            Ref<Image> img = Image::load_from_file(texture_pathname);
-            tex = ImageTexture::create_from_image(img);
-            tex->take_over_path(texture_pathname);
-        } else {
-            tex = res_loader->load(texture_pathname);
-        }
-
-        this->_renderer_resource.ary_texture.append(tex);
-    }
-}
-
-
 void InternalCubismUserModel::pro_update(const float delta) {
     if(this->IsInitialized() == false) return;
     if(this->_model_setting == nullptr) return;
@@ -221,7 +314,10 @@ void InternalCubismUserModel::epi_update(const float delta) {
         if(this->_pose != nullptr) { this->_pose->UpdateParameters(this->_model, delta); }
     }
 
-    this->_model->Update();
+    // CubismModel::Update() resets the drawable dynamic flags right after csmUpdateModel.
+    // The renderer reads them in update_node() and resets them itself once consumed,
+    // so changes made while update_node() is skipped are not lost.
+    Live2D::Cubism::Core::csmUpdateModel(this->_model->GetModel());
     this->effect_batch(delta, EFFECT_CALL_EPILOGUE);
 }
 
@@ -240,12 +336,92 @@ void InternalCubismUserModel::update_node() {
 }
 
 
+void InternalCubismUserModel::update_bounds() {
+    if(this->IsInitialized() == false) return;
+
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    renderer->update_bounds(this->_renderer_resource);
+}
+
+
+bool InternalCubismUserModel::impostor_capture(const float scale) {
+    if(this->IsInitialized() == false) return false;
+
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    return renderer->capture_impostor(this->_renderer_resource, scale);
+}
+
+
+void InternalCubismUserModel::impostor_release() {
+    this->_renderer_resource.release_impostor();
+}
+
+
+void InternalCubismUserModel::mirror_build(const RID root, Csm::csmVector<RID> &items) {
+    if(this->IsInitialized() == false) return;
+
+    #ifdef GD_CUBISM_USE_RENDERER_2D
+    InternalCubismRenderer2D* renderer = this->GetRenderer<InternalCubismRenderer2D>();
+    #else
+    #endif // GD_CUBISM_USE_RENDERER_2D
+
+    renderer->build_mirror(this->_renderer_resource, root, items);
+}
+
+
+Rect2 InternalCubismUserModel::mirror_rect() const {
+    // the model canvas in drawable space, drawables are placed relative to the model origin
+    const InternalCubismRendererResource &res = this->_renderer_resource;
+    return Rect2(-res.CALCULATED_ORIGIN_C, Vector2(res.vct_canvas_size));
+}
+
+
+void InternalCubismUserModel::mirror_update(InternalCubismRenderer3D &renderer, const bool structure_changed) {
+    if(this->IsInitialized() == false) return;
+
+    renderer.update(this->GetModel(), this->_renderer_resource, structure_changed);
+}
+
+
 void InternalCubismUserModel::clear() {
 
     this->DeleteRenderer();
 
     this->_renderer_resource.clear();
 
+    this->release_motions();
+
+    this->effect_term();
+
+    this->_list_eye_blink.Clear();
+    this->_list_lipsync.Clear();
+
+    if(this->_model_setting != nullptr) {
+        this->_initialized = false;
+
+        // owned by the data, see InternalCubismModelData
+        this->_model_setting = nullptr;
+    }
+}
+
+
+void InternalCubismUserModel::release_model() {
+    // the moc is shared, CubismUserModel would delete it along with the model
+    if(this->_moc != nullptr && this->_model != nullptr) this->_moc->DeleteModel(this->_model);
+    this->_model = nullptr;
+    this->_moc = nullptr;
+}
+
+
+void InternalCubismUserModel::release_motions() {
     {
         this->expression_stop();
         for(csmMap<csmString,CubismExpressionMotion*>::const_iterator i = this->_map_expression.Begin(); i != this->_map_expression.End(); i++) {
@@ -261,18 +437,6 @@ void InternalCubismUserModel::clear() {
         }
         this->_map_motion.Clear();
     }
-
-    this->effect_term();
-
-    this->_list_eye_blink.Clear();
-    this->_list_lipsync.Clear();
-
-    if(this->_model_setting != nullptr) {
-        this->_initialized = false;
-
-        CSM_DELETE(this->_model_setting);
-        this->_model_setting = nullptr;
-    }
 }
 
 
@@ -353,7 +517,7 @@ void InternalCubismUserModel::expression_load() {
         String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetExpressionFileName(i));
         String expression_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
 
-        PackedByteArray buffer = FileAccess::get_file_as_bytes(expression_pathname);
+        PackedByteArray buffer = this->_model_data->get_file(expression_pathname);
         CubismExpressionMotion* motion = static_cast<CubismExpressionMotion*>(this->LoadExpression(
             buffer.ptr(),
             buffer.size(),
@@ -376,7 +540,7 @@ void InternalCubismUserModel::physics_load() {
     String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetPhysicsFileName());
     String physics_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
 
-    PackedByteArray buffer = FileAccess::get_file_as_bytes(physics_pathname);
+    PackedByteArray buffer = this->_model_data->get_file(physics_pathname);
     if(buffer.size() > 0) {
         this->LoadPhysics(buffer.ptr(), buffer.size());
     }
@@ -389,7 +553,7 @@ void InternalCubismUserModel::pose_load() {
     String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetPoseFileName());
     String pose_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
 
-    PackedByteArray buffer = FileAccess::get_file_as_bytes(pose_pathname);
+    PackedByteArray buffer = this->_model_data->get_file(pose_pathname);
     if(buffer.size() > 0) {
         this->LoadPose(buffer.ptr(), buffer.size());
     }
@@ -402,7 +566,7 @@ void InternalCubismUserModel::userdata_load() {
     String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetUserDataFile());
     String userdata_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
 
-    PackedByteArray buffer = FileAccess::get_file_as_bytes(userdata_pathname);
+    PackedByteArray buffer = this->_model_data->get_file(userdata_pathname);
     if(buffer.size() > 0) {
         this->LoadUserData(buffer.ptr(), buffer.size());
     }
@@ -428,7 +592,7 @@ void InternalCubismUserModel::motion_load() {
             String gd_filename; gd_filename.parse_utf8(this->_model_setting->GetMotionFileName(group, im));
             String motion_pathname = this->_model_pathname.get_base_dir().path_join(gd_filename);
 
-            PackedByteArray buffer = FileAccess::get_file_as_bytes(motion_pathname);
+            PackedByteArray buffer = this->_model_data->get_file(motion_pathname);
             CubismMotion* motion = static_cast<CubismMotion*>(this->LoadMotion(
                 buffer.ptr(),
                 buffer.size(),
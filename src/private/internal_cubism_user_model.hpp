@@ -27,6 +27,8 @@ class GDCubismEffectBreath;
 class GDCubismEffectCustom;
 class GDCubismEffectEyeBlink;
 class GDCubismEffectHitArea;
+class InternalCubismModelData;
+class InternalCubismRenderer3D;
 
 
 // ------------------------------------------------------------------- class(s)
@@ -54,19 +56,37 @@ private:
     InternalCubismRendererResource _renderer_resource;
     GDCubismUserModel::moc3FileFormatVersion _moc3_file_format_version;
     String _model_pathname;
+    // shared with every model loaded from the same GDCubismModelData, which owns it and the moc
     Csm::ICubismModelSetting* _model_setting;
     Csm::csmVector<Csm::CubismIdHandle> _list_eye_blink;
     Csm::csmVector<Csm::CubismIdHandle> _list_lipsync;
     Csm::csmMap<Csm::csmString,Csm::CubismExpressionMotion*> _map_expression;
     Csm::csmMap<Csm::csmString,Csm::CubismMotion*> _map_motion;
+    // files of the model being set up, only valid inside model_setup()
+    const InternalCubismModelData *_model_data;
+    Csm::csmInt32 _build_index;
 
 public:
-    bool model_load(const String &model_pathname);
-    void model_load_resource();
+    // creates the model from the shared moc of the data, the drawables are built separately
+    bool model_load(InternalCubismModelData &data);
+    // loads a variant sharing the drawable layout of the current moc, keeping the built nodes,
+    // meshes and materials. false when it does not match, the model is then to be loaded anew
+    bool model_swap(InternalCubismModelData &data);
+    void build(const bool hidden);
+    // one drawable per step, true once everything is built. hidden drawables are shown by the first update
+    void build_begin(const bool hidden);
+    bool build_step();
+    float get_build_progress() const;
     void pro_update(const float delta);
     void efx_update(const float delta);
     void epi_update(const float delta);
     void update_node();
+    void update_bounds();
+    bool impostor_capture(const float scale);
+    void impostor_release();
+    void mirror_build(const RID root, Csm::csmVector<RID> &items);
+    Rect2 mirror_rect() const;
+    void mirror_update(InternalCubismRenderer3D &renderer, const bool structure_changed);
     void clear();
 
     void stop();
@@ -80,6 +100,12 @@ public:
     virtual void MotionEventFired(const Csm::csmString& eventValue) override;
 
 private:
+    void model_adopt(InternalCubismModelData &data, Csm::CubismModel *model);
+    bool model_setup(const InternalCubismModelData &data);
+    bool check_swap(Csm::ICubismModelSetting *setting, const Csm::CubismModel *model);
+    void release_motions();
+    void release_model();
+
     void expression_load();
     void physics_load();
     void pose_load();
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <float.h>
+
+#include <private/internal_cubism_vertex_kernel.hpp>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define GD_CUBISM_VERTEX_KERNEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define GD_CUBISM_VERTEX_KERNEL_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define GD_CUBISM_VERTEX_KERNEL_NEON
+#endif
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// csmVector2 pairs written back to back, the layout of a 2D vertex stream without normals
+const static int32_t PACKED_VERTEX_STRIDE = sizeof(float) * 2;
+
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+// ------------------------------------------------------------------ method(s)
+Rect2 write_Vertices_scalar(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit,
+    const int32_t &stride,
+    uint8_t *dst)
+{
+    if (size == 0) return Rect2();
+
+    float min_x = FLT_MAX;
+    float min_y = FLT_MAX;
+    float max_x = -FLT_MAX;
+    float max_y = -FLT_MAX;
+
+    for (int32_t i = 0; i < size; i++)
+    {
+        const float x = ptr[i].X * ppunit;
+        const float y = ptr[i].Y * -ppunit;
+        float *vtx = reinterpret_cast<float *>(dst + i * stride);
+        vtx[0] = x;
+        vtx[1] = y;
+
+        min_x = x < min_x ? x : min_x;
+        min_y = y < min_y ? y : min_y;
+        max_x = x > max_x ? x : max_x;
+        max_y = y > max_y ? y : max_y;
+    }
+
+    return Rect2(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+
+Rect2 write_Vertices(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit,
+    const int32_t &stride,
+    uint8_t *dst)
+{
+    if (size == 0) return Rect2();
+    if (stride != PACKED_VERTEX_STRIDE) return write_Vertices_scalar(ptr, size, ppunit, stride, dst);
+
+    const float *src = reinterpret_cast<const float *>(ptr);
+    float *out = reinterpret_cast<float *>(dst);
+    float lo[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    float hi[4] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    int32_t i = 0;
+
+    // every lane pair holds one (x, y) vertex, the bounds are reduced over the even and odd lanes
+    #if defined(GD_CUBISM_VERTEX_KERNEL_AVX)
+    {
+        const __m256 scale = _mm256_setr_ps(ppunit, -ppunit, ppunit, -ppunit, ppunit, -ppunit, ppunit, -ppunit);
+        __m256 vmin = _mm256_set1_ps(FLT_MAX);
+        __m256 vmax = _mm256_set1_ps(-FLT_MAX);
+
+        for (; i + 4 <= size; i += 4)
+        {
+            const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i * 2), scale);
+            _mm256_storeu_ps(out + i * 2, v);
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+        }
+
+        _mm_storeu_ps(lo, _mm_min_ps(_mm256_castps256_ps128(vmin), _mm256_extractf128_ps(vmin, 1)));
+        _mm_storeu_ps(hi, _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1)));
+    }
+    #elif defined(GD_CUBISM_VERTEX_KERNEL_SSE2)
+    {
+        const __m128 scale = _mm_setr_ps(ppunit, -ppunit, ppunit, -ppunit);
+        __m128 vmin = _mm_set1_ps(FLT_MAX);
+        __m128 vmax = _mm_set1_ps(-FLT_MAX);
+
+        for (; i + 2 <= size; i += 2)
+        {
+            const __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i * 2), scale);
+            _mm_storeu_ps(out + i * 2, v);
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+        }
+
+        _mm_storeu_ps(lo, vmin);
+        _mm_storeu_ps(hi, vmax);
+    }
+    #elif defined(GD_CUBISM_VERTEX_KERNEL_NEON)
+    {
+        const float lanes[4] = { ppunit, -ppunit, ppunit, -ppunit };
+        const float32x4_t scale = vld1q_f32(lanes);
+        float32x4_t vmin = vdupq_n_f32(FLT_MAX);
+        float32x4_t vmax = vdupq_n_f32(-FLT_MAX);
+
+        for (; i + 2 <= size; i += 2)
+        {
+            const float32x4_t v = vmulq_f32(vld1q_f32(src + i * 2), scale);
+            vst1q_f32(out + i * 2, v);
+            vmin = vminq_f32(vmin, v);
+            vmax = vmaxq_f32(vmax, v);
+        }
+
+        vst1q_f32(lo, vmin);
+        vst1q_f32(hi, vmax);
+    }
+    #endif
+
+    float min_x = lo[0] < lo[2] ? lo[0] : lo[2];
+    float min_y = lo[1] < lo[3] ? lo[1] : lo[3];
+    float max_x = hi[0] > hi[2] ? hi[0] : hi[2];
+    float max_y = hi[1] > hi[3] ? hi[1] : hi[3];
+
+    if (i < size) {
+        const Rect2 tail = write_Vertices_scalar(ptr + i, size - i, ppunit, stride, dst + i * stride);
+        min_x = tail.position.x < min_x ? tail.position.x : min_x;
+        min_y = tail.position.y < min_y ? tail.position.y : min_y;
+        max_x = tail.position.x + tail.size.x > max_x ? tail.position.x + tail.size.x : max_x;
+        max_y = tail.position.y + tail.size.y > max_y ? tail.position.y + tail.size.y : max_y;
+    }
+
+    return Rect2(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+
+Rect2 bounds_Vertices(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit)
+{
+    if (size == 0) return Rect2();
+
+    float min_x = FLT_MAX;
+    float min_y = FLT_MAX;
+    float max_x = -FLT_MAX;
+    float max_y = -FLT_MAX;
+
+    // plain enough for the compiler to vectorize on its own, the conversion is applied to the extremes only
+    for (int32_t i = 0; i < size; i++)
+    {
+        min_x = ptr[i].X < min_x ? ptr[i].X : min_x;
+        min_y = ptr[i].Y < min_y ? ptr[i].Y : min_y;
+        max_x = ptr[i].X > max_x ? ptr[i].X : max_x;
+        max_y = ptr[i].Y > max_y ? ptr[i].Y : max_y;
+    }
+
+    return Rect2(
+        min_x * ppunit, max_y * -ppunit,
+        (max_x - min_x) * ppunit, (max_y - min_y) * ppunit);
+}
+
+
+void lerp_Positions(
+    const Live2D::Cubism::Core::csmVector2 *from,
+    const Live2D::Cubism::Core::csmVector2 *to,
+    const int32_t &size,
+    const float &weight,
+    Live2D::Cubism::Core::csmVector2 *dst)
+{
+    // plain enough for the compiler to vectorize on its own
+    for (int32_t i = 0; i < size; i++)
+    {
+        dst[i].X = from[i].X + (to[i].X - from[i].X) * weight;
+        dst[i].Y = from[i].Y + (to[i].Y - from[i].Y) * weight;
+    }
+}
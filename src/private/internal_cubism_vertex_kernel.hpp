@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: 2023 MizunagiKB <mizukb@live.jp>
+#ifndef INTERNAL_CUBISM_VERTEX_KERNEL
+#define INTERNAL_CUBISM_VERTEX_KERNEL
+
+
+// ----------------------------------------------------------------- include(s)
+#include <gd_cubism.hpp>
+
+#include <godot_cpp/variant/rect2.hpp>
+
+#include <Live2DCubismCore.hpp>
+
+
+// ------------------------------------------------------------------ define(s)
+// --------------------------------------------------------------- namespace(s)
+using namespace godot;
+
+
+// -------------------------------------------------------------------- enum(s)
+// ------------------------------------------------------------------- const(s)
+// ------------------------------------------------------------------ static(s)
+// ----------------------------------------------------------- class:forward(s)
+// ------------------------------------------------------------------- class(s)
+// ------------------------------------------------------------------ method(s)
+
+// Converts Cubism vertex positions to canvas space (flip Y, scale by ppunit),
+// writes them as float pairs every `stride` bytes into `dst` and returns their bounds.
+// A tightly packed destination (stride == 8) takes the vectorized path.
+Rect2 write_Vertices(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit,
+    const int32_t &stride,
+    uint8_t *dst);
+
+// Reference implementation of write_Vertices, also used for the remainder of the vector path.
+Rect2 write_Vertices_scalar(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit,
+    const int32_t &stride,
+    uint8_t *dst);
+
+// Bounds write_Vertices would return for the same positions, without writing anything.
+// Used for drawables that are not drawn but still have to be followed.
+Rect2 bounds_Vertices(
+    const Live2D::Cubism::Core::csmVector2 *ptr,
+    const int32_t &size,
+    const float &ppunit);
+
+// Blends two sets of Cubism vertex positions, `weight` 0 gives `from` and 1 gives `to`.
+void lerp_Positions(
+    const Live2D::Cubism::Core::csmVector2 *from,
+    const Live2D::Cubism::Core::csmVector2 *to,
+    const int32_t &size,
+    const float &weight,
+    Live2D::Cubism::Core::csmVector2 *dst);
+
+
+#endif // INTERNAL_CUBISM_VERTEX_KERNEL
@@ -8,14 +8,23 @@
 
 #include <CubismFramework.hpp>
 
+#include <loaders/gd_cubism_model_loader.hpp>
 #include <loaders/gd_cubism_motion_loader.hpp>
 #include <private/internal_cubism_allocator.hpp>
+#include <private/internal_cubism_load_request.hpp>
+#include <private/internal_cubism_mask_budget.hpp>
+#include <private/internal_cubism_object_pool.hpp>
+#include <gd_cubism_benchmark.hpp>
 #include <gd_cubism_effect.hpp>
 #include <gd_cubism_effect_breath.hpp>
 #include <gd_cubism_effect_custom.hpp>
 #include <gd_cubism_effect_eye_blink.hpp>
 #include <gd_cubism_effect_hit_area.hpp>
 #include <gd_cubism_effect_target_point.hpp>
+#include <gd_cubism_level_of_detail.hpp>
+#include <gd_cubism_model_3d.hpp>
+#include <gd_cubism_model_data.hpp>
+#include <gd_cubism_model_texture.hpp>
 #include <gd_cubism_motion_entry.hpp>
 #include <gd_cubism_value_abs.hpp>
 #include <gd_cubism_value_parameter.hpp>
@@ -31,6 +40,7 @@ static InternalCubismAllocator allocator;
 static Csm::CubismFramework::Option option;
 
 static Ref<GDCubismMotionLoader> motionLoader;
+static Ref<GDCubismModelLoader> modelLoader;
 
 // -------------------------------------------------------------------- enum(s)
 // ------------------------------------------------------------------- const(s)
@@ -74,15 +84,27 @@ void initialize_gd_cubism_module(ModuleInitializationLevel p_level) {
     GDREGISTER_CLASS(GDCubismParameter);
     GDREGISTER_CLASS(GDCubismPartOpacity);
 
+    GDREGISTER_CLASS(GDCubismLevelOfDetail);
+    GDREGISTER_CLASS(GDCubismModelData);
+    GDREGISTER_CLASS(GDCubismModelTexture);
+    GDREGISTER_CLASS(GDCubismModel3D);
+
+    #ifdef DEBUG_ENABLED
+    GDREGISTER_CLASS(GDCubismBenchmark);
+    #endif // DEBUG_ENABLED
+
     ClassDB::register_class<GDCubismMotionLoader>();
+    ClassDB::register_class<GDCubismModelLoader>();
     ClassDB::register_class<GDCubismMotionQueueEntryHandle>();
     ClassDB::register_class<GDCubismMotionEntry>();
     ClassDB::register_class<GDCubismUserModel>();
 
     motionLoader.instantiate();
+    modelLoader.instantiate();
 
     // prioritize our format loaders so that the more generic json loader isn't preferred
     ResourceLoader::get_singleton()->add_resource_format_loader(motionLoader, true);
+    ResourceLoader::get_singleton()->add_resource_format_loader(modelLoader, true);
 }
 
 void uninitialize_gd_cubism_module(ModuleInitializationLevel p_level) {
@@ -96,7 +118,12 @@ void uninitialize_gd_cubism_module(ModuleInitializationLevel p_level) {
 
     ResourceLoader::get_singleton()->remove_resource_format_loader(motionLoader);
     motionLoader.unref();
+    ResourceLoader::get_singleton()->remove_resource_format_loader(modelLoader);
+    modelLoader.unref();
     
+    InternalCubismLoadRequest::clear();
+    InternalCubismMaskBudget::clear();
+    InternalCubismObjectPool::clear();
     Csm::CubismFramework::Dispose();
 }
 